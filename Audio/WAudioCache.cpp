@@ -0,0 +1,201 @@
+#include "WAudioCache.h"
+#include "../WTowerStats.h"
+#include "../WTowerMemory.h"
+#include "Engine/AssetManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "Sound/SoundBase.h"
+
+UWAudioCache::UWAudioCache()
+{
+    // Инициализация по умолчанию
+    MemoryBudgetKB = 32768;
+    ResidentBytes = 0;
+    UseCounter = 0;
+    Hits = 0;
+    Misses = 0;
+}
+
+//----------------------------------------------------------------------------------------
+// ЗАГРУЗКА
+//----------------------------------------------------------------------------------------
+
+void UWAudioCache::PreloadCues(const TArray<TSoftObjectPtr<USoundBase>>& Cues)
+{
+    TArray<FSoftObjectPath> ToLoad;
+    for (const TSoftObjectPtr<USoundBase>& Cue : Cues)
+    {
+        if (Cue.IsNull())
+            continue;
+
+        // Звуки, загруженные вместе с картой или при переходе, добавляются сразу
+        if (USoundBase* Sound = Cue.Get())
+        {
+            Insert(Sound);
+        }
+        else
+        {
+            ToLoad.Add(Cue.ToSoftObjectPath());
+        }
+    }
+
+    if (PreloadHandle.IsValid())
+    {
+        PreloadHandle->CancelHandle();
+        PreloadHandle.Reset();
+    }
+
+    if (ToLoad.Num() > 0)
+    {
+        PreloadHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(ToLoad,
+            FStreamableDelegate::CreateUObject(this, &UWAudioCache::OnPreloadFinished, ToLoad));
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("WAudioCache: Preloading %d cues (%d already loaded)"),
+        Cues.Num(), Cues.Num() - ToLoad.Num());
+}
+
+void UWAudioCache::OnPreloadFinished(TArray<FSoftObjectPath> Cues)
+{
+    for (const FSoftObjectPath& Cue : Cues)
+    {
+        if (USoundBase* Sound = Cast<USoundBase>(Cue.ResolveObject()))
+        {
+            Insert(Sound);
+        }
+    }
+    PreloadHandle.Reset();
+
+    UE_LOG(LogTemp, Log, TEXT("WAudioCache: %d cues resident, %lld KB of %d KB"),
+        Entries.Num(), ResidentBytes / 1024, MemoryBudgetKB);
+}
+
+void UWAudioCache::OnMissLoaded(FSoftObjectPath Cue)
+{
+    if (USoundBase* Sound = Cast<USoundBase>(Cue.ResolveObject()))
+    {
+        Insert(Sound);
+    }
+
+    MissHandles.RemoveAll([](const TSharedPtr<FStreamableHandle>& Handle)
+        {
+            return !Handle.IsValid() || Handle->HasLoadCompleted();
+        });
+}
+
+//----------------------------------------------------------------------------------------
+// ОБРАЩЕНИЯ
+//----------------------------------------------------------------------------------------
+
+void UWAudioCache::Touch(USoundBase* Sound)
+{
+    if (!Sound)
+        return;
+
+    if (FWAudioCacheEntry* Entry = Entries.Find(FSoftObjectPath(Sound)))
+    {
+        Entry->LastUse = ++UseCounter;
+        ++Hits;
+        INC_DWORD_STAT(STAT_TowerAudioCacheHits);
+        return;
+    }
+
+    // Звук не был объявлен для уровня: первый запуск мог ждать диска, дальше он в кэше
+    ++Misses;
+    INC_DWORD_STAT(STAT_TowerAudioCacheMisses);
+    UE_LOG(LogTemp, Verbose, TEXT("WAudioCache: Miss on %s"), *Sound->GetName());
+    Insert(Sound);
+}
+
+USoundBase* UWAudioCache::Resolve(const TSoftObjectPtr<USoundBase>& Cue)
+{
+    if (Cue.IsNull())
+        return nullptr;
+
+    // Загруженный звук учитывается в Touch при воспроизведении
+    if (const FWAudioCacheEntry* Entry = Entries.Find(Cue.ToSoftObjectPath()))
+    {
+        return Entry->Sound;
+    }
+    if (USoundBase* Sound = Cue.Get())
+    {
+        return Sound;
+    }
+
+    // Этот запуск пропускается, следующий найдет звук в кэше
+    ++Misses;
+    INC_DWORD_STAT(STAT_TowerAudioCacheMisses);
+
+    const FSoftObjectPath CuePath = Cue.ToSoftObjectPath();
+    MissHandles.Add(UAssetManager::GetStreamableManager().RequestAsyncLoad(CuePath,
+        FStreamableDelegate::CreateUObject(this, &UWAudioCache::OnMissLoaded, CuePath),
+        FStreamableManager::AsyncLoadHighPriority));
+
+    UE_LOG(LogTemp, Warning, TEXT("WAudioCache: %s is not loaded, loading in background"), *CuePath.ToString());
+    return nullptr;
+}
+
+float UWAudioCache::GetHitRate() const
+{
+    const int32 Total = Hits + Misses;
+    return Total > 0 ? static_cast<float>(Hits) / Total : 1.0f;
+}
+
+void UWAudioCache::LogReport(const FString& Context)
+{
+    if (Hits + Misses > 0)
+    {
+        UE_LOG(LogTemp, Log, TEXT("WAudioCache: %s - %d hits, %d misses (%.1f%% hit rate), %d cues, %lld KB"),
+            *Context, Hits, Misses, GetHitRate() * 100.0f, Entries.Num(), ResidentBytes / 1024);
+    }
+
+    Hits = 0;
+    Misses = 0;
+}
+
+//----------------------------------------------------------------------------------------
+// ПАМЯТЬ
+//----------------------------------------------------------------------------------------
+
+void UWAudioCache::Insert(USoundBase* Sound)
+{
+    LLM_SCOPE_BYTAG(Tower_Audio);
+
+    FWAudioCacheEntry& Entry = Entries.FindOrAdd(FSoftObjectPath(Sound));
+    Entry.LastUse = ++UseCounter;
+    if (Entry.Sound == Sound)
+        return;
+
+    Entry.Sound = Sound;
+    Entry.Bytes = Sound->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+    ResidentBytes += Entry.Bytes;
+
+    // Первый потоковый блок кэшируется заранее, чтобы запуск звука не ждал диска
+    UGameplayStatics::PrimeSound(Sound);
+
+    EvictToBudget();
+}
+
+void UWAudioCache::EvictToBudget()
+{
+    const int64 BudgetBytes = static_cast<int64>(MemoryBudgetKB) * 1024;
+
+    // Самый свежий звук не вытесняется, даже если один превышает бюджет
+    while (ResidentBytes > BudgetBytes && Entries.Num() > 1)
+    {
+        FSoftObjectPath Oldest;
+        uint64 OldestUse = MAX_uint64;
+        for (const TPair<FSoftObjectPath, FWAudioCacheEntry>& Pair : Entries)
+        {
+            if (Pair.Value.LastUse < OldestUse)
+            {
+                OldestUse = Pair.Value.LastUse;
+                Oldest = Pair.Key;
+            }
+        }
+
+        ResidentBytes -= Entries[Oldest].Bytes;
+        Entries.Remove(Oldest);
+    }
+
+    SET_DWORD_STAT(STAT_TowerAudioCacheResidentKB, ResidentBytes / 1024);
+}
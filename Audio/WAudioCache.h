@@ -0,0 +1,100 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "Engine/StreamableManager.h"
+#include "WAudioCache.generated.h"
+
+class USoundBase;
+
+/**
+ * Звук, удерживаемый кэшем
+ */
+USTRUCT()
+struct FWAudioCacheEntry
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    USoundBase* Sound;
+
+    // Оценка занимаемой памяти (байт)
+    int64 Bytes;
+
+    // Номер последнего обращения (для вытеснения давно не звучавших)
+    uint64 LastUse;
+
+    FWAudioCacheEntry()
+        : Sound(nullptr)
+        , Bytes(0)
+        , LastUse(0)
+    {
+    }
+};
+
+/**
+ * Кэш звуковых эффектов.
+ * При входе на уровень асинхронно загружает объявленный набор звуков уровня
+ * и их первые потоковые блоки, затем держит звуки в памяти в пределах бюджета,
+ * вытесняя давно не звучавшие. Каждое обращение считается попаданием или промахом,
+ * поэтому по логу уровня видно, какие звуки не были объявлены заранее.
+ */
+UCLASS()
+class WTOWER_API UWAudioCache : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    UWAudioCache();
+
+    // Загрузить набор звуков уровня в фоне и оставить его в кэше
+    void PreloadCues(const TArray<TSoftObjectPtr<USoundBase>>& Cues);
+
+    // Отметить воспроизведение звука: попадание, если он уже в кэше, иначе промах и добавление
+    void Touch(USoundBase* Sound);
+
+    // Загруженный звук по мягкой ссылке; незагруженный грузится в фоне (промах, результат nullptr).
+    // Синхронной загрузки не бывает
+    USoundBase* Resolve(const TSoftObjectPtr<USoundBase>& Cue);
+
+    // Записать в лог статистику и начать подсчет заново
+    void LogReport(const FString& Context);
+
+    int32 GetHits() const { return Hits; }
+    int32 GetMisses() const { return Misses; }
+
+    // Доля попаданий (0-1); без обращений - 1
+    float GetHitRate() const;
+
+    // Количество звуков в кэше
+    int32 GetNumEntries() const { return Entries.Num(); }
+
+    // Занимаемая звуками кэша память (байт)
+    int64 GetResidentBytes() const { return ResidentBytes; }
+
+    // Бюджет памяти кэша (КБ)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Аудио|Кэш", meta = (ClampMin = "0"))
+    int32 MemoryBudgetKB;
+
+private:
+    UPROPERTY()
+    TMap<FSoftObjectPath, FWAudioCacheEntry> Entries;
+
+    int64 ResidentBytes;
+    uint64 UseCounter;
+    int32 Hits;
+    int32 Misses;
+
+    // Загрузки в фоне (набор уровня и отдельные промахи)
+    TSharedPtr<FStreamableHandle> PreloadHandle;
+    TArray<TSharedPtr<FStreamableHandle>> MissHandles;
+
+    // Добавить загруженный звук и подготовить его первый потоковый блок
+    void Insert(USoundBase* Sound);
+
+    void OnPreloadFinished(TArray<FSoftObjectPath> Cues);
+    void OnMissLoaded(FSoftObjectPath Cue);
+
+    // Вытеснять давно не звучавшие звуки, пока кэш больше бюджета
+    void EvictToBudget();
+};
@@ -1,26 +1,123 @@
 #include "WAudioManager.h"
 #include "../WTowerGameInstance.h"
 #include "../Config/WTowerGameConfig.h"
+#include "../WTowerStats.h"
+#include "../WTowerMemory.h"
 #include "Kismet/GameplayStatics.h"
+#include "Sound/SoundMix.h"
+#include "Sound/SoundClass.h"
+#include "UObject/UObjectGlobals.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
 
 UWAudioManager::UWAudioManager()
 {
     // Инициализация по умолчанию
     GameInstance = nullptr;
-    BackgroundMusicComponent = nullptr;
+    MusicPlayer = nullptr;
+    AudioCache = nullptr;
     CurrentMasterVolume = 1.0f;
     CurrentMusicVolume = 1.0f;
     CurrentSFXVolume = 1.0f;
-    SavedMasterVolume = 1.0f;
     bIsMuted = false;
+    VolumeMix = nullptr;
+    MasterSoundClass = nullptr;
+    MusicSoundClass = nullptr;
+    SFXSoundClass = nullptr;
+    bClassRouting = false;
+
+    // Пул голосов: интерфейс не вытесняется игровыми звуками, мир - самый низкий приоритет
+    VoicePoolSize = 16;
+    CategorySettings.SetNum(static_cast<int32>(EWSoundCategory::Count));
+    CategorySettings[static_cast<int32>(EWSoundCategory::UI)] = FWVoiceCategorySettings(3, 3, 0.0f);
+    CategorySettings[static_cast<int32>(EWSoundCategory::Player)] = FWVoiceCategorySettings(4, 2, 0.0f);
+    CategorySettings[static_cast<int32>(EWSoundCategory::World)] = FWVoiceCategorySettings(8, 0, 4000.0f);
+    CategorySettings[static_cast<int32>(EWSoundCategory::PowerUp)] = FWVoiceCategorySettings(4, 1, 4000.0f);
+
+    VoicesStarted = 0;
+    VoicesStolen = 0;
+    VoicesMerged = 0;
+    VoicesCulled = 0;
 }
 
 void UWAudioManager::Initialize(UWTowerGameInstance* InGameInstance)
 {
+    LLM_SCOPE_BYTAG(Tower_Audio);
     GameInstance = InGameInstance;
+
+    MusicPlayer = NewObject<UWMusicPlayer>(this);
+    MusicPlayer->Initialize(GameInstance);
+
+    AudioCache = NewObject<UWAudioCache>(this);
+
+    InitializeRouting(GameInstance->AudioRouting);
     ApplySoundSettings();
+
+    // Базовый микс задается в аудиоустройстве мира, поэтому после смены карты применяем его снова
+    PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &UWAudioManager::OnPostLoadMap);
     
-    UE_LOG(LogTemp, Log, TEXT("WAudioManager: Initialized"));
+    UE_LOG(LogTemp, Log, TEXT("WAudioManager: Initialized (%s)"), bClassRouting ? TEXT("sound class routing") : TEXT("per-component volume"));
+}
+
+void UWAudioManager::InitializeRouting(const FWAudioRouting& Routing)
+{
+    // Ассеты маленькие и загружаются один раз при запуске
+    VolumeMix = Routing.VolumeMix.LoadSynchronous();
+    MasterSoundClass = Routing.MasterSoundClass.LoadSynchronous();
+    MusicSoundClass = Routing.MusicSoundClass.LoadSynchronous();
+    SFXSoundClass = Routing.SFXSoundClass.LoadSynchronous();
+
+    bClassRouting = VolumeMix && MasterSoundClass && MusicSoundClass && SFXSoundClass;
+    if (!bClassRouting && !Routing.VolumeMix.IsNull())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("WAudioManager: Audio routing is incomplete, falling back to per-component volume"));
+    }
+}
+
+void UWAudioManager::OnPostLoadMap(UWorld* LoadedWorld)
+{
+    ApplyVolumes();
+
+    // Статистика кэша считается по уровням; звуки нового уровня грузятся до первого прыжка
+    AudioCache->LogReport(TEXT("Previous level"));
+
+    const UWLevelRegistry* Registry = GameInstance ? GameInstance->GetLevelRegistry() : nullptr;
+    const FWLevelEntry* Entry = Registry ? Registry->FindEntry(GameInstance->GetCurrentLevelId()) : nullptr;
+    if (Entry && Entry->AudioCues.Num() > 0)
+    {
+        AudioCache->PreloadCues(Entry->AudioCues);
+    }
+}
+
+void UWAudioManager::ApplyVolumes()
+{
+    const float MasterVolume = bIsMuted ? 0.0f : CurrentMasterVolume;
+
+    if (!bClassRouting)
+    {
+        // Без классов звука громкость меняется только у музыки, эффекты учитывают ее при запуске
+        MusicPlayer->SetVolume(MasterVolume * CurrentMusicVolume);
+        return;
+    }
+
+    UWorld* World = GameInstance ? GameInstance->GetWorld() : nullptr;
+    if (!World)
+        return;
+
+    // Переопределения классов в микс-модификаторе действуют на все звучащие голоса сразу;
+    // громкость основного класса распространяется на дочерние (музыка и эффекты)
+    UGameplayStatics::SetBaseSoundMix(World, VolumeMix);
+    UGameplayStatics::SetSoundMixClassOverride(World, VolumeMix, MasterSoundClass, MasterVolume, 1.0f, 0.0f, true);
+    UGameplayStatics::SetSoundMixClassOverride(World, VolumeMix, MusicSoundClass, CurrentMusicVolume, 1.0f, 0.0f, true);
+    UGameplayStatics::SetSoundMixClassOverride(World, VolumeMix, SFXSoundClass, CurrentSFXVolume, 1.0f, 0.0f, true);
+}
+
+float UWAudioManager::GetComponentVolume(float CategoryVolume) const
+{
+    // При маршрутизации через классы звука множитель компонента не используется
+    if (bClassRouting)
+        return 1.0f;
+    return bIsMuted ? 0.0f : CurrentMasterVolume * CategoryVolume;
 }
 
 void UWAudioManager::ApplySoundSettings()
@@ -29,26 +126,13 @@ void UWAudioManager::ApplySoundSettings()
     {
         UWTowerGameConfig* Config = GameInstance->GetGameConfig();
         
-        // Получаем значения громкости из конфига
+        // Получаем значения громкости и отключения звука из конфига
         CurrentMasterVolume = Config->MasterVolume;
         CurrentMusicVolume = Config->MusicVolume;
         CurrentSFXVolume = Config->SFXVolume;
+        bIsMuted = Config->bMuteAudio;
         
-        // Если есть активная музыка, обновляем её громкость
-        if (BackgroundMusicComponent && BackgroundMusicComponent->IsPlaying())
-        {
-            BackgroundMusicComponent->SetVolumeMultiplier(CurrentMasterVolume * CurrentMusicVolume);
-        }
-        
-        // Применяем настройку отключения звука
-        if (Config->bMuteAudio && !bIsMuted)
-        {
-            MuteAllSounds();
-        }
-        else if (!Config->bMuteAudio && bIsMuted)
-        {
-            UnmuteAllSounds();
-        }
+        ApplyVolumes();
     }
 }
 
@@ -57,12 +141,7 @@ void UWAudioManager::SetMasterVolume(float Volume)
     // Ограничиваем громкость диапазоном 0-1
     Volume = FMath::Clamp(Volume, 0.0f, 1.0f);
     CurrentMasterVolume = Volume;
-    
-    // Обновляем громкость фоновой музыки
-    if (BackgroundMusicComponent)
-    {
-        BackgroundMusicComponent->SetVolumeMultiplier(CurrentMasterVolume * CurrentMusicVolume);
-    }
+    ApplyVolumes();
     
     // Обновляем настройку в конфиге
     if (GameInstance && GameInstance->GetGameConfig())
@@ -78,12 +157,7 @@ void UWAudioManager::SetMusicVolume(float Volume)
     // Ограничиваем громкость диапазоном 0-1
     Volume = FMath::Clamp(Volume, 0.0f, 1.0f);
     CurrentMusicVolume = Volume;
-    
-    // Обновляем громкость фоновой музыки
-    if (BackgroundMusicComponent)
-    {
-        BackgroundMusicComponent->SetVolumeMultiplier(CurrentMasterVolume * CurrentMusicVolume);
-    }
+    ApplyVolumes();
     
     // Обновляем настройку в конфиге
     if (GameInstance && GameInstance->GetGameConfig())
@@ -99,6 +173,7 @@ void UWAudioManager::SetSFXVolume(float Volume)
     // Ограничиваем громкость диапазоном 0-1
     Volume = FMath::Clamp(Volume, 0.0f, 1.0f);
     CurrentSFXVolume = Volume;
+    ApplyVolumes();
     
     // Обновляем настройку в конфиге
     if (GameInstance && GameInstance->GetGameConfig())
@@ -113,14 +188,9 @@ void UWAudioManager::MuteAllSounds()
 {
     if (!bIsMuted)
     {
-        // Сохраняем текущую громкость
-        SavedMasterVolume = CurrentMasterVolume;
-        
-        // Отключаем звук
-        SetMasterVolume(0.0f);
-        
-        // Устанавливаем флаг отключенного звука
+        // Громкость основного класса обнуляется, сохраненные значения не меняются
         bIsMuted = true;
+        ApplyVolumes();
         
         // Обновляем настройку в конфиге
         if (GameInstance && GameInstance->GetGameConfig())
@@ -136,11 +206,8 @@ void UWAudioManager::UnmuteAllSounds()
 {
     if (bIsMuted)
     {
-        // Восстанавливаем громкость
-        SetMasterVolume(SavedMasterVolume);
-        
-        // Снимаем флаг отключенного звука
         bIsMuted = false;
+        ApplyVolumes();
         
         // Обновляем настройку в конфиге
         if (GameInstance && GameInstance->GetGameConfig())
@@ -152,62 +219,227 @@ void UWAudioManager::UnmuteAllSounds()
     }
 }
 
-void UWAudioManager::PlaySoundEffect(USoundBase* Sound, FVector Location)
+void UWAudioManager::PlaySoundEffect(USoundBase* Sound, FVector Location, EWSoundCategory SoundCategory)
 {
-    if (Sound && !bIsMuted)
+    UWorld* World = GameInstance ? GameInstance->GetWorld() : nullptr;
+    if (!Sound)
+        return;
+
+    // Обращение учитывается и при отключенном звуке: набор звуков уровня от этого не меняется
+    AudioCache->Touch(Sound);
+
+    if (bIsMuted || !EnsureVoicePool(World))
+        return;
+
+    const FWVoiceCategorySettings& Settings = CategorySettings[static_cast<int32>(SoundCategory)];
+    const bool bSpatial = !Location.IsZero();
+
+    // Звук вне слышимости не занимает голос
+    if (bSpatial && IsBeyondCullDistance(World, Location, Settings.CullDistance))
     {
-        // Воспроизводим звук с учетом настроек громкости
-        float FinalVolume = CurrentMasterVolume * CurrentSFXVolume;
-        
-        if (Location.IsZero())
-        {
-            // Обычный 2D звук
-            UGameplayStatics::PlaySound2D(GameInstance, Sound, FinalVolume);
-        }
-        else
+        ++VoicesCulled;
+        INC_DWORD_STAT(STAT_TowerVoicesCulled);
+        return;
+    }
+
+    // Тот же звук уже запущен в этом кадре (например, несколько подборов разом) - одного достаточно
+    for (int32 Index = 0; Index < VoiceStates.Num(); ++Index)
+    {
+        if (VoiceStates[Index].StartFrame == GFrameCounter && VoiceStates[Index].Sound == Sound && IsVoiceActive(Index))
         {
-            // 3D звук с указанием позиции
-            UGameplayStatics::PlaySoundAtLocation(GameInstance, Sound, Location, FRotator::ZeroRotator, FinalVolume);
+            ++VoicesMerged;
+            INC_DWORD_STAT(STAT_TowerVoicesMerged);
+            return;
         }
     }
+
+    const int32 VoiceIndex = AcquireVoice(SoundCategory);
+    if (VoiceIndex == INDEX_NONE)
+    {
+        ++VoicesCulled;
+        INC_DWORD_STAT(STAT_TowerVoicesCulled);
+        return;
+    }
+
+    UAudioComponent* Voice = VoiceComponents[VoiceIndex];
+    if (Voice->IsPlaying())
+    {
+        ++VoicesStolen;
+        INC_DWORD_STAT(STAT_TowerVoicesStolen);
+        Voice->Stop();
+    }
+
+    // Воспроизводим звук с учетом настроек громкости
+    Voice->SetSound(Sound);
+    Voice->bAllowSpatialization = bSpatial;
+    Voice->bIsUISound = SoundCategory == EWSoundCategory::UI;
+    Voice->SetWorldLocation(Location);
+    Voice->SetVolumeMultiplier(GetComponentVolume(CurrentSFXVolume));
+    Voice->Play();
+
+    FVoiceState& State = VoiceStates[VoiceIndex];
+    State.Category = SoundCategory;
+    State.Sound = Sound;
+    State.StartFrame = GFrameCounter;
+    State.StartTime = FPlatformTime::Seconds();
+
+    ++VoicesStarted;
+    INC_DWORD_STAT(STAT_TowerVoicesStarted);
 }
 
-void UWAudioManager::PlayBackgroundMusic(USoundBase* Music)
+void UWAudioManager::PlayCachedSound(const TSoftObjectPtr<USoundBase>& Sound, FVector Location, EWSoundCategory SoundCategory)
 {
-    if (Music)
+    // Незагруженный звук пропускается и грузится в фоне, игровой поток не ждет диска
+    if (USoundBase* Loaded = AudioCache->Resolve(Sound))
     {
-        // Останавливаем текущую фоновую музыку, если она играет
-        StopBackgroundMusic();
+        PlaySoundEffect(Loaded, Location, SoundCategory);
+    }
+}
 
-        // Создаем новый компонент для воспроизведения фоновой музыки
-        // Параметр зацикливания теперь не требуется, т.к. он настроен в самом звуковом файле
-        BackgroundMusicComponent = UGameplayStatics::CreateSound2D(GameInstance, Music);
+//----------------------------------------------------------------------------------------
+// ПУЛ ГОЛОСОВ
+//----------------------------------------------------------------------------------------
 
-        if (BackgroundMusicComponent)
-        {
+bool UWAudioManager::EnsureVoicePool(UWorld* World)
+{
+    if (!World)
+        return false;
+
+    if (VoiceWorld.Get() == World && VoiceComponents.Num() > 0)
+        return true;
+
+    // Компоненты регистрируются в мире и уходят вместе с ним при смене карты
+    LLM_SCOPE_BYTAG(Tower_Audio);
+    VoiceComponents.Reset();
+    VoiceStates.Reset();
+    VoiceWorld = World;
+
+    for (int32 Index = 0; Index < VoicePoolSize; ++Index)
+    {
+        UAudioComponent* Voice = NewObject<UAudioComponent>(World);
+        Voice->bAutoActivate = false;
+        Voice->bAutoDestroy = false;
+        Voice->bStopWhenOwnerDestroyed = false;
+        Voice->RegisterComponentWithWorld(World);
 
-            BackgroundMusicComponent->bAutoDestroy = false;
+        VoiceComponents.Add(Voice);
+        VoiceStates.AddDefaulted();
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("WAudioManager: Created %d pooled voices"), VoicePoolSize);
+    return true;
+}
+
+bool UWAudioManager::IsVoiceActive(int32 VoiceIndex) const
+{
+    const UAudioComponent* Voice = VoiceComponents[VoiceIndex];
+    return Voice && Voice->IsPlaying();
+}
 
-            // Устанавливаем громкость
-            float FinalVolume = bIsMuted ? 0.0f : (CurrentMasterVolume * CurrentMusicVolume);
-            BackgroundMusicComponent->SetVolumeMultiplier(FinalVolume);
+int32 UWAudioManager::GetActiveVoiceCount() const
+{
+    int32 Count = 0;
+    for (int32 Index = 0; Index < VoiceComponents.Num(); ++Index)
+    {
+        Count += IsVoiceActive(Index) ? 1 : 0;
+    }
+    return Count;
+}
+
+int32 UWAudioManager::AcquireVoice(EWSoundCategory Category)
+{
+    const FWVoiceCategorySettings& Settings = CategorySettings[static_cast<int32>(Category)];
+
+    int32 FreeVoice = INDEX_NONE;
+    int32 OldestInCategory = INDEX_NONE;
+    int32 CategoryVoices = 0;
+    int32 LowestPriorityVoice = INDEX_NONE;
+
+    for (int32 Index = 0; Index < VoiceStates.Num(); ++Index)
+    {
+        if (!IsVoiceActive(Index))
+        {
+            if (FreeVoice == INDEX_NONE)
+            {
+                FreeVoice = Index;
+            }
+            continue;
+        }
 
-            // Запускаем воспроизведение
-            BackgroundMusicComponent->Play();
+        const FVoiceState& State = VoiceStates[Index];
+        if (State.Category == Category)
+        {
+            ++CategoryVoices;
+            if (OldestInCategory == INDEX_NONE || State.StartTime < VoiceStates[OldestInCategory].StartTime)
+            {
+                OldestInCategory = Index;
+            }
+        }
 
-            UE_LOG(LogTemp, Log, TEXT("WAudioManager: Started playing background music"));
+        // Среди голосов с наименьшим приоритетом выбираем самый старый
+        const int32 Priority = CategorySettings[static_cast<int32>(State.Category)].Priority;
+        if (LowestPriorityVoice == INDEX_NONE)
+        {
+            LowestPriorityVoice = Index;
+        }
+        else
+        {
+            const FVoiceState& Lowest = VoiceStates[LowestPriorityVoice];
+            const int32 LowestPriority = CategorySettings[static_cast<int32>(Lowest.Category)].Priority;
+            if (Priority < LowestPriority || (Priority == LowestPriority && State.StartTime < Lowest.StartTime))
+            {
+                LowestPriorityVoice = Index;
+            }
         }
     }
+
+    // Лимит категории: новый звук заменяет самый старый своей категории
+    if (CategoryVoices >= Settings.MaxVoices)
+    {
+        return OldestInCategory;
+    }
+
+    if (FreeVoice != INDEX_NONE)
+    {
+        return FreeVoice;
+    }
+
+    // Пул занят: вытесняем менее (или так же) приоритетный голос
+    if (LowestPriorityVoice != INDEX_NONE
+        && CategorySettings[static_cast<int32>(VoiceStates[LowestPriorityVoice].Category)].Priority <= Settings.Priority)
+    {
+        return LowestPriorityVoice;
+    }
+    return INDEX_NONE;
 }
 
-void UWAudioManager::StopBackgroundMusic()
+bool UWAudioManager::IsBeyondCullDistance(UWorld* World, const FVector& Location, float CullDistance) const
 {
-    if (BackgroundMusicComponent && BackgroundMusicComponent->IsPlaying())
+    if (CullDistance <= 0.0f)
+        return false;
+
+    APlayerController* PlayerController = World->GetFirstPlayerController();
+    if (!PlayerController)
+        return false;
+
+    FVector ListenerLocation;
+    FVector ListenerFront;
+    FVector ListenerRight;
+    PlayerController->GetAudioListenerPosition(ListenerLocation, ListenerFront, ListenerRight);
+    return FVector::DistSquared(ListenerLocation, Location) > FMath::Square(CullDistance);
+}
+
+void UWAudioManager::PlayBackgroundMusic(USoundBase* Music)
+{
+    // Новый трек сменяет текущий плавным переходом, без паузы между ними
+    if (Music)
     {
-        // Останавливаем воспроизведение фоновой музыки
-        BackgroundMusicComponent->Stop();
-        BackgroundMusicComponent = nullptr;
-        
-        UE_LOG(LogTemp, Log, TEXT("WAudioManager: Stopped background music"));
+        MusicPlayer->PlaySound(Music);
     }
+}
+
+void UWAudioManager::StopBackgroundMusic()
+{
+    MusicPlayer->Stop();
+    UE_LOG(LogTemp, Log, TEXT("WAudioManager: Stopped background music"));
 }
\ No newline at end of file
@@ -3,8 +3,90 @@
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
 #include "Components/AudioComponent.h"
+#include "WMusicPlayer.h"
+#include "WAudioCache.h"
 #include "WAudioManager.generated.h"
 
+class USoundMix;
+class USoundClass;
+
+// Категория звука (лимиты и приоритеты голосов)
+UENUM(BlueprintType)
+enum class EWSoundCategory : uint8
+{
+    UI UMETA(DisplayName = "UI"),
+    Player UMETA(DisplayName = "Player"),
+    World UMETA(DisplayName = "World"),
+    PowerUp UMETA(DisplayName = "Power Up"),
+    Count UMETA(Hidden)
+};
+
+/**
+ * Настройки голосов категории звуков
+ */
+USTRUCT(BlueprintType)
+struct FWVoiceCategorySettings
+{
+    GENERATED_BODY()
+
+    // Максимум одновременно звучащих голосов категории
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Аудио", meta = (ClampMin = "1"))
+    int32 MaxVoices;
+
+    // Приоритет: новый звук может занять голос с приоритетом не выше своего
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Аудио")
+    int32 Priority;
+
+    // Звуки дальше этого расстояния от слушателя не запускаются (0 - без отсечения)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Аудио", meta = (ClampMin = "0.0"))
+    float CullDistance;
+
+    FWVoiceCategorySettings()
+        : MaxVoices(4)
+        , Priority(0)
+        , CullDistance(0.0f)
+    {
+    }
+
+    FWVoiceCategorySettings(int32 InMaxVoices, int32 InPriority, float InCullDistance)
+        : MaxVoices(InMaxVoices)
+        , Priority(InPriority)
+        , CullDistance(InCullDistance)
+    {
+    }
+};
+
+/**
+ * Маршрутизация громкости: микс-модификатор и классы звука.
+ * Музыка и эффекты в ассетах назначаются классам Music и SFX, дочерним к Master
+ */
+USTRUCT(BlueprintType)
+struct FWAudioRouting
+{
+    GENERATED_BODY()
+
+    // Микс, в котором переопределяется громкость классов
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Аудио")
+    TSoftObjectPtr<USoundMix> VolumeMix;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Аудио")
+    TSoftObjectPtr<USoundClass> MasterSoundClass;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Аудио")
+    TSoftObjectPtr<USoundClass> MusicSoundClass;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Аудио")
+    TSoftObjectPtr<USoundClass> SFXSoundClass;
+};
+
+/**
+ * Аудио менеджер: громкость, фоновая музыка и пул голосов для звуковых эффектов.
+ * Громкость применяется переопределением классов звука в миксе и сразу действует
+ * на все звучащие голоса; без настроенной маршрутизации используются множители компонентов.
+ * Эффекты проигрываются переиспользуемыми компонентами с лимитами по категориям,
+ * приоритетами и отсечением по расстоянию; одинаковые звуки в одном кадре объединяются.
+ * Звуки уровня загружаются при входе на него и удерживаются кэшем
+ */
 UCLASS(Blueprintable, BlueprintType)
 class WTOWER_API UWAudioManager : public UObject
 {
@@ -39,7 +121,11 @@ public:
     
     // Воспроизведение звуков
     UFUNCTION(BlueprintCallable, Category = "Аудио")
-    void PlaySoundEffect(USoundBase* Sound, FVector Location = FVector::ZeroVector);
+    void PlaySoundEffect(USoundBase* Sound, FVector Location = FVector::ZeroVector, EWSoundCategory SoundCategory = EWSoundCategory::World);
+    
+    // Воспроизведение по мягкой ссылке через кэш (без синхронной загрузки)
+    UFUNCTION(BlueprintCallable, Category = "Аудио")
+    void PlayCachedSound(const TSoftObjectPtr<USoundBase>& Sound, FVector Location = FVector::ZeroVector, EWSoundCategory SoundCategory = EWSoundCategory::World);
     
     UFUNCTION(BlueprintCallable, Category = "Аудио")
     void PlayBackgroundMusic(USoundBase* Music);
@@ -47,23 +133,122 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Аудио")
     void StopBackgroundMusic();
 
+    // Проигрыватель музыки (плавные переходы, предзагрузка, слои по высоте)
+    UFUNCTION(BlueprintCallable, Category = "Аудио")
+    UWMusicPlayer* GetMusicPlayer() const { return MusicPlayer; }
+
+    // Кэш звуковых эффектов уровня
+    UWAudioCache* GetAudioCache() const { return AudioCache; }
+
+    //----------------------------------------------------------------------------------------
+    // ПУЛ ГОЛОСОВ
+    //----------------------------------------------------------------------------------------
+
+    // Размер пула голосов для звуковых эффектов
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Аудио|Голоса", meta = (ClampMin = "1"))
+    int32 VoicePoolSize;
+
+    // Настройки голосов по категориям (индекс = EWSoundCategory)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Аудио|Голоса")
+    TArray<FWVoiceCategorySettings> CategorySettings;
+
+    // Количество запущенных, вытесненных, объединенных и отсеченных звуков
+    UFUNCTION(BlueprintCallable, Category = "Аудио|Голоса")
+    int32 GetVoicesStarted() const { return VoicesStarted; }
+
+    UFUNCTION(BlueprintCallable, Category = "Аудио|Голоса")
+    int32 GetVoicesStolen() const { return VoicesStolen; }
+
+    UFUNCTION(BlueprintCallable, Category = "Аудио|Голоса")
+    int32 GetVoicesMerged() const { return VoicesMerged; }
+
+    UFUNCTION(BlueprintCallable, Category = "Аудио|Голоса")
+    int32 GetVoicesCulled() const { return VoicesCulled; }
+
+    // Количество звучащих голосов
+    UFUNCTION(BlueprintCallable, Category = "Аудио|Голоса")
+    int32 GetActiveVoiceCount() const;
+
 private:
     // Ссылка на GameInstance
     UPROPERTY()
     class UWTowerGameInstance* GameInstance;
     
-    // Компонент для фоновой музыки
+    // Проигрыватель фоновой музыки
+    UPROPERTY()
+    UWMusicPlayer* MusicPlayer;
+
+    // Кэш звуковых эффектов
     UPROPERTY()
-    UAudioComponent* BackgroundMusicComponent;
+    UWAudioCache* AudioCache;
     
     // Текущие значения громкости
     float CurrentMasterVolume;
     float CurrentMusicVolume;
     float CurrentSFXVolume;
     
-    // Сохраненное значение громкости до отключения
-    float SavedMasterVolume;
-    
     // Флаг отключенного звука
     bool bIsMuted;
+
+    // Микс и классы звука для громкости
+    UPROPERTY()
+    USoundMix* VolumeMix;
+
+    UPROPERTY()
+    USoundClass* MasterSoundClass;
+
+    UPROPERTY()
+    USoundClass* MusicSoundClass;
+
+    UPROPERTY()
+    USoundClass* SFXSoundClass;
+
+    // Громкость идет через классы звука (все ассеты маршрутизации заданы)
+    bool bClassRouting;
+
+    FDelegateHandle PostLoadMapHandle;
+
+    void InitializeRouting(const FWAudioRouting& Routing);
+    void OnPostLoadMap(UWorld* LoadedWorld);
+
+    // Применить громкость и отключение: одно переопределение на класс, без обхода компонентов
+    void ApplyVolumes();
+
+    // Множитель громкости нового компонента
+    float GetComponentVolume(float CategoryVolume) const;
+
+    // Состояние голоса пула
+    struct FVoiceState
+    {
+        EWSoundCategory Category = EWSoundCategory::World;
+        TWeakObjectPtr<USoundBase> Sound;
+        uint64 StartFrame = 0;
+        double StartTime = 0.0;
+    };
+
+    // Компоненты пула (создаются в текущем мире) и их состояние
+    UPROPERTY()
+    TArray<UAudioComponent*> VoiceComponents;
+
+    TArray<FVoiceState> VoiceStates;
+
+    // Мир, в котором создан пул
+    TWeakObjectPtr<UWorld> VoiceWorld;
+
+    int32 VoicesStarted;
+    int32 VoicesStolen;
+    int32 VoicesMerged;
+    int32 VoicesCulled;
+
+    // Создать пул в мире (старый пул принадлежал выгруженному миру)
+    bool EnsureVoicePool(UWorld* World);
+
+    // Найти голос для нового звука: свободный, самый старый в категории или менее приоритетный.
+    // INDEX_NONE, если все голоса заняты звуками с большим приоритетом
+    int32 AcquireVoice(EWSoundCategory Category);
+
+    bool IsVoiceActive(int32 VoiceIndex) const;
+
+    // Слишком ли далеко звук от слушателя
+    bool IsBeyondCullDistance(UWorld* World, const FVector& Location, float CullDistance) const;
 };
\ No newline at end of file
@@ -0,0 +1,279 @@
+#include "WMusicPlayer.h"
+#include "../WTowerGameInstance.h"
+#include "../Gameplay/WTowerRunSubsystem.h"
+#include "../WTowerMemory.h"
+#include "Components/AudioComponent.h"
+#include "Engine/AssetManager.h"
+#include "Engine/World.h"
+#include "Kismet/GameplayStatics.h"
+#include "UObject/UObjectGlobals.h"
+
+UWMusicPlayer::UWMusicPlayer()
+{
+    // Инициализация по умолчанию
+    CrossfadeTime = 2.0f;
+    MaxPrefetchedTracks = 3;
+    GameInstance = nullptr;
+    DeckA = nullptr;
+    DeckB = nullptr;
+    bDeckAActive = true;
+    CurrentLayer = INDEX_NONE;
+    Volume = 1.0f;
+}
+
+void UWMusicPlayer::Initialize(UWTowerGameInstance* InGameInstance)
+{
+    GameInstance = InGameInstance;
+    PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &UWMusicPlayer::OnPostLoadMap);
+}
+
+//----------------------------------------------------------------------------------------
+// ВОСПРОИЗВЕДЕНИЕ
+//----------------------------------------------------------------------------------------
+
+void UWMusicPlayer::PlayTrack(const TSoftObjectPtr<USoundBase>& Track)
+{
+    if (Track.IsNull())
+        return;
+
+    if (USoundBase* Sound = Track.Get())
+    {
+        PendingTrack.Reset();
+        CrossfadeTo(Sound);
+        return;
+    }
+
+    // Трек не был загружен заранее: текущий продолжает играть, пока новый грузится
+    PendingTrack = Track.ToSoftObjectPath();
+    PendingTrackHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(PendingTrack,
+        FStreamableDelegate::CreateUObject(this, &UWMusicPlayer::OnTrackLoaded, PendingTrack),
+        FStreamableManager::AsyncLoadHighPriority);
+}
+
+void UWMusicPlayer::PlaySound(USoundBase* Sound)
+{
+    if (Sound)
+    {
+        PendingTrack.Reset();
+        CrossfadeTo(Sound);
+    }
+}
+
+void UWMusicPlayer::OnTrackLoaded(FSoftObjectPath Track)
+{
+    // За время загрузки мог быть запрошен другой трек
+    if (Track != PendingTrack)
+        return;
+
+    PendingTrack.Reset();
+    PendingTrackHandle.Reset();
+    if (USoundBase* Sound = Cast<USoundBase>(Track.ResolveObject()))
+    {
+        UGameplayStatics::PrimeSound(Sound);
+        CrossfadeTo(Sound);
+    }
+}
+
+void UWMusicPlayer::Stop()
+{
+    PendingTrack.Reset();
+    PendingTrackHandle.Reset();
+
+    UAudioComponent* Active = GetActiveDeck();
+    if (Active && Active->IsPlaying())
+    {
+        Active->FadeOut(CrossfadeTime, 0.0f);
+    }
+}
+
+void UWMusicPlayer::SetVolume(float InVolume)
+{
+    Volume = InVolume;
+    for (UAudioComponent* Deck : { DeckA, DeckB })
+    {
+        if (Deck)
+        {
+            Deck->SetVolumeMultiplier(Volume);
+        }
+    }
+}
+
+USoundBase* UWMusicPlayer::GetCurrentTrack() const
+{
+    const UAudioComponent* Active = GetActiveDeck();
+    return Active && Active->IsPlaying() ? Active->Sound : nullptr;
+}
+
+UAudioComponent* UWMusicPlayer::EnsureDeck(UAudioComponent*& Deck, USoundBase* Sound)
+{
+    if (!IsValid(Deck))
+    {
+        LLM_SCOPE_BYTAG(Tower_Audio);
+        Deck = UGameplayStatics::CreateSound2D(GameInstance, Sound, Volume, 1.0f, 0.0f, nullptr, true, false);
+    }
+    return Deck;
+}
+
+void UWMusicPlayer::CrossfadeTo(USoundBase* Sound)
+{
+    UAudioComponent* Active = GetActiveDeck();
+    if (Active && Active->IsPlaying() && Active->Sound == Sound)
+        return;
+
+    // Новый трек запускается на свободной деке, текущая затухает одновременно с ним
+    UAudioComponent* Incoming = EnsureDeck(bDeckAActive ? DeckB : DeckA, Sound);
+    if (!Incoming)
+        return;
+
+    Incoming->SetSound(Sound);
+    Incoming->SetVolumeMultiplier(Volume);
+    Incoming->FadeIn(CrossfadeTime, 1.0f);
+
+    if (Active && Active->IsPlaying())
+    {
+        Active->FadeOut(CrossfadeTime, 0.0f);
+    }
+    bDeckAActive = !bDeckAActive;
+
+    UE_LOG(LogTemp, Log, TEXT("WMusicPlayer: Crossfading to %s"), *Sound->GetName());
+}
+
+//----------------------------------------------------------------------------------------
+// ПРЕДЗАГРУЗКА
+//----------------------------------------------------------------------------------------
+
+void UWMusicPlayer::PrefetchTrack(const TSoftObjectPtr<USoundBase>& Track)
+{
+    if (Track.IsNull())
+        return;
+
+    if (Track.Get())
+    {
+        OnPrefetchLoaded(Track.ToSoftObjectPath());
+        return;
+    }
+
+    PrefetchHandles.RemoveAll([](const TSharedPtr<FStreamableHandle>& Handle)
+        {
+            return !Handle.IsValid() || Handle->HasLoadCompleted();
+        });
+
+    const FSoftObjectPath TrackPath = Track.ToSoftObjectPath();
+    PrefetchHandles.Add(UAssetManager::GetStreamableManager().RequestAsyncLoad(TrackPath,
+        FStreamableDelegate::CreateUObject(this, &UWMusicPlayer::OnPrefetchLoaded, TrackPath)));
+}
+
+void UWMusicPlayer::OnPrefetchLoaded(FSoftObjectPath Track)
+{
+    USoundBase* Sound = Cast<USoundBase>(Track.ResolveObject());
+    if (!Sound)
+        return;
+
+    // Первый потоковый блок кэшируется заранее, чтобы старт трека не ждал диска
+    UGameplayStatics::PrimeSound(Sound);
+
+    PrefetchedTracks.Remove(Sound);
+    PrefetchedTracks.Add(Sound);
+    while (PrefetchedTracks.Num() > MaxPrefetchedTracks)
+    {
+        PrefetchedTracks.RemoveAt(0);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+// МУЗЫКА УРОВНЯ И СЛОИ ПО ВЫСОТЕ
+//----------------------------------------------------------------------------------------
+
+void UWMusicPlayer::OnPostLoadMap(UWorld* LoadedWorld)
+{
+    if (UWTowerRunSubsystem* OldRun = BoundRun.Get())
+    {
+        OldRun->OnHeightChanged.Remove(HeightChangedHandle);
+        OldRun->OnRunReset.Remove(RunResetHandle);
+    }
+    BoundRun = nullptr;
+
+    const UWLevelRegistry* Registry = GameInstance ? GameInstance->GetLevelRegistry() : nullptr;
+    const FWLevelEntry* Entry = Registry ? Registry->FindEntry(GameInstance->GetCurrentLevelId()) : nullptr;
+    if (!Entry)
+        return;
+
+    if (Entry->MusicLayers.Num() > 0)
+    {
+        SetHeightLayers(Entry->MusicLayers);
+
+        // Слои переключаются по событию высоты забега, без опроса
+        if (UWTowerRunSubsystem* Run = UWTowerRunSubsystem::Get(LoadedWorld))
+        {
+            HeightChangedHandle = Run->OnHeightChanged.AddUObject(this, &UWMusicPlayer::OnHeightChanged);
+            RunResetHandle = Run->OnRunReset.AddWeakLambda(this, [this]()
+                {
+                    SetHeightLayers(Layers);
+                });
+            BoundRun = Run;
+        }
+    }
+    else
+    {
+        SetHeightLayers(TArray<FWMusicLayer>());
+        PlayTrack(Entry->Music);
+    }
+
+    // Пока играет этот уровень, готовим музыку следующего
+    const int32 NextIndex = GameInstance->GetCurrentLevelIndex() + 1;
+    if (NextIndex < Registry->GetNumLevels())
+    {
+        const FWLevelEntry& NextEntry = Registry->GetEntryAt(NextIndex);
+        PrefetchTrack(NextEntry.MusicLayers.Num() > 0 ? NextEntry.MusicLayers[0].Track : NextEntry.Music);
+    }
+}
+
+void UWMusicPlayer::SetHeightLayers(const TArray<FWMusicLayer>& InLayers)
+{
+    Layers = InLayers;
+    Layers.Sort([](const FWMusicLayer& A, const FWMusicLayer& B)
+        {
+            return A.MinHeight < B.MinHeight;
+        });
+
+    CurrentLayer = INDEX_NONE;
+    if (Layers.Num() > 0)
+    {
+        CurrentLayer = 0;
+        PlayTrack(Layers[0].Track);
+        if (Layers.Num() > 1)
+        {
+            PrefetchTrack(Layers[1].Track);
+        }
+    }
+}
+
+int32 UWMusicPlayer::FindLayer(float Height) const
+{
+    int32 Found = INDEX_NONE;
+    for (int32 Index = 0; Index < Layers.Num() && Layers[Index].MinHeight <= Height; ++Index)
+    {
+        Found = Index;
+    }
+    return Found;
+}
+
+void UWMusicPlayer::OnHeightChanged(float CurrentHeight, float MaxHeight, bool bNewMax)
+{
+    // Слой зависит от максимальной высоты, поэтому не мигает при падениях около границы
+    if (!bNewMax || Layers.Num() == 0)
+        return;
+
+    const int32 Layer = FindLayer(MaxHeight);
+    if (Layer == INDEX_NONE || Layer == CurrentLayer)
+        return;
+
+    CurrentLayer = Layer;
+    PlayTrack(Layers[Layer].Track);
+
+    // Следующий слой готовится, пока играет текущий
+    if (Layers.IsValidIndex(Layer + 1))
+    {
+        PrefetchTrack(Layers[Layer + 1].Track);
+    }
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "Engine/StreamableManager.h"
+#include "../Levels/WLevelRegistry.h"
+#include "WMusicPlayer.generated.h"
+
+class UAudioComponent;
+class UWTowerGameInstance;
+class UWTowerRunSubsystem;
+
+/**
+ * Проигрыватель музыки.
+ * Две деки (компоненты, переживающие смену карты) сменяют друг друга плавным переходом.
+ * Треки загружаются асинхронно и заранее: пока играет текущий, для следующего
+ * (музыка следующего уровня, следующий слой по высоте) подгружается ассет
+ * и первый потоковый блок, поэтому смена трека не грузит ничего на игровом потоке.
+ */
+UCLASS()
+class WTOWER_API UWMusicPlayer : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    UWMusicPlayer();
+
+    // Инициализация (подписка на загрузку карт)
+    void Initialize(UWTowerGameInstance* InGameInstance);
+
+    // Плавно перейти на трек; незагруженный трек загружается в фоне, переход - по готовности
+    void PlayTrack(const TSoftObjectPtr<USoundBase>& Track);
+
+    // Плавно перейти на уже загруженный звук
+    void PlaySound(USoundBase* Sound);
+
+    // Плавно остановить музыку
+    void Stop();
+
+    // Загрузить трек и его первый потоковый блок, не начиная воспроизведение
+    void PrefetchTrack(const TSoftObjectPtr<USoundBase>& Track);
+
+    // Задать слои музыки по высоте (пустой массив - без слоев)
+    void SetHeightLayers(const TArray<FWMusicLayer>& InLayers);
+
+    // Множитель громкости дек (используется без маршрутизации через классы звука)
+    void SetVolume(float InVolume);
+
+    // Текущий трек
+    USoundBase* GetCurrentTrack() const;
+
+    // Длительность плавного перехода (секунды)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Музыка")
+    float CrossfadeTime;
+
+    // Сколько загруженных заранее треков держать в памяти
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Музыка")
+    int32 MaxPrefetchedTracks;
+
+private:
+    UPROPERTY()
+    UWTowerGameInstance* GameInstance;
+
+    // Деки: одна звучит, вторая готова принять следующий трек
+    UPROPERTY()
+    UAudioComponent* DeckA;
+
+    UPROPERTY()
+    UAudioComponent* DeckB;
+
+    bool bDeckAActive;
+
+    // Загруженные заранее треки (от старых к новым)
+    UPROPERTY()
+    TArray<USoundBase*> PrefetchedTracks;
+
+    // Трек, который начнет играть после асинхронной загрузки
+    FSoftObjectPath PendingTrack;
+    TSharedPtr<FStreamableHandle> PendingTrackHandle;
+    TArray<TSharedPtr<FStreamableHandle>> PrefetchHandles;
+
+    // Слои по высоте и текущий слой
+    TArray<FWMusicLayer> Layers;
+    int32 CurrentLayer;
+
+    float Volume;
+
+    // Подписка на высоту забега текущего мира
+    TWeakObjectPtr<UWTowerRunSubsystem> BoundRun;
+    FDelegateHandle HeightChangedHandle;
+    FDelegateHandle RunResetHandle;
+    FDelegateHandle PostLoadMapHandle;
+
+    UAudioComponent* GetActiveDeck() const { return bDeckAActive ? DeckA : DeckB; }
+
+    // Деку создаем при первом треке; она не уничтожается при смене карты
+    UAudioComponent* EnsureDeck(UAudioComponent*& Deck, USoundBase* Sound);
+
+    void CrossfadeTo(USoundBase* Sound);
+    void OnTrackLoaded(FSoftObjectPath Track);
+    void OnPrefetchLoaded(FSoftObjectPath Track);
+    void OnPostLoadMap(UWorld* LoadedWorld);
+    void OnHeightChanged(float CurrentHeight, float MaxHeight, bool bNewMax);
+
+    // Слой для высоты (INDEX_NONE, если слоев нет)
+    int32 FindLayer(float Height) const;
+};
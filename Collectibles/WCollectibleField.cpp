@@ -0,0 +1,392 @@
+#include "WCollectibleField.h"
+#include "../GameManager.h"
+#include "../WTowerMemory.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Kismet/GameplayStatics.h"
+#include "EngineUtils.h"
+
+AWCollectibleField::AWCollectibleField()
+{
+    PrimaryActorTick.bCanEverTick = true;
+
+    RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+
+    // Предметы рисуются инстансами и не участвуют в коллизиях
+    CoinInstances = CreateDefaultSubobject<UInstancedStaticMeshComponent>(TEXT("CoinInstances"));
+    CoinInstances->SetupAttachment(RootComponent);
+    CoinInstances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+    CoinInstances->SetGenerateOverlapEvents(false);
+
+    PowerUpInstances = CreateDefaultSubobject<UInstancedStaticMeshComponent>(TEXT("PowerUpInstances"));
+    PowerUpInstances->SetupAttachment(RootComponent);
+    PowerUpInstances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+    PowerUpInstances->SetGenerateOverlapEvents(false);
+    PowerUpInstances->NumCustomDataFloats = 3; // Цвет усиления для материала
+
+    // Значения по умолчанию
+    CellSize = 400.0f;
+    CollectRadius = 60.0f;
+    MagnetRadius = 800.0f;
+    MagnetSpeed = 1500.0f;
+    PowerUpDuration = 5.0f;
+    PowerUpStrength = 1.0f;
+
+    NumAlive = 0;
+    MagnetTimeRemaining = 0.0f;
+    bCoinsRenderDirty = false;
+    bPowerUpsRenderDirty = false;
+    PickupApplier = nullptr;
+}
+
+void AWCollectibleField::BeginPlay()
+{
+    Super::BeginPlay();
+
+    // Компонент создается один раз и настраивается перед каждым применением
+    {
+        LLM_SCOPE_BYTAG(Tower_PowerUps);
+        PickupApplier = NewObject<UPowerUpComponent>(this, TEXT("PickupApplier"));
+        PickupApplier->RegisterComponent();
+    }
+
+    const int32 NumInitial = InitialCollectibles.Num();
+    Positions.Reserve(NumInitial);
+    ItemCells.Reserve(NumInitial);
+    InstanceIndices.Reserve(NumInitial);
+    ScoreValues.Reserve(NumInitial);
+    Kinds.Reserve(NumInitial);
+    PowerUpTypes.Reserve(NumInitial);
+
+    ResetCollectibles();
+
+    UE_LOG(LogTemp, Log, TEXT("WCollectibleField: %d collectibles in %d cells"), NumAlive, Cells.Num());
+}
+
+//----------------------------------------------------------------------------------------
+// УПРАВЛЕНИЕ ПРЕДМЕТАМИ
+//----------------------------------------------------------------------------------------
+
+int32 AWCollectibleField::AddCollectible(const FWCollectibleSpawn& Spawn)
+{
+    UInstancedStaticMeshComponent* Instances = GetInstancesForKind(Spawn.Kind);
+    const int32 Item = Positions.Num();
+
+    Positions.Add(Spawn.Location);
+    Kinds.Add(Spawn.Kind);
+    PowerUpTypes.Add(Spawn.PowerUpType);
+    ScoreValues.Add(Spawn.ScoreValue);
+    AliveFlags.Add(true);
+    AttractedFlags.Add(false);
+
+    const int32 InstanceIndex = Instances->AddInstance(FTransform(Spawn.Location), true);
+    InstanceIndices.Add(InstanceIndex);
+
+    if (Spawn.Kind == EWCollectibleKind::PowerUp)
+    {
+        const FLinearColor Color = UPowerUpComponent::GetColorForPowerUpType(Spawn.PowerUpType);
+        Instances->SetCustomDataValue(InstanceIndex, 0, Color.R, false);
+        Instances->SetCustomDataValue(InstanceIndex, 1, Color.G, false);
+        Instances->SetCustomDataValue(InstanceIndex, 2, Color.B, true);
+    }
+
+    const FIntVector Cell = GetCellCoord(Spawn.Location);
+    ItemCells.Add(Cell);
+    InsertIntoCell(Item, Cell);
+
+    ++NumAlive;
+    return Item;
+}
+
+void AWCollectibleField::ClearCollectibles()
+{
+    CoinInstances->ClearInstances();
+    PowerUpInstances->ClearInstances();
+
+    Positions.Reset();
+    ItemCells.Reset();
+    InstanceIndices.Reset();
+    ScoreValues.Reset();
+    Kinds.Reset();
+    PowerUpTypes.Reset();
+    AliveFlags.Reset();
+    AttractedFlags.Reset();
+    Cells.Reset();
+    AttractedItems.Reset();
+    NumAlive = 0;
+}
+
+void AWCollectibleField::ResetCollectibles()
+{
+    ClearCollectibles();
+
+    for (const FWCollectibleSpawn& Spawn : InitialCollectibles)
+    {
+        AddCollectible(Spawn);
+    }
+
+    Collector.Reset();
+    MagnetTimeRemaining = 0.0f;
+}
+
+//----------------------------------------------------------------------------------------
+// МАГНИТ
+//----------------------------------------------------------------------------------------
+
+void AWCollectibleField::ActivateMagnet(AActor* Target, float Duration)
+{
+    if (!Target)
+        return;
+
+    Collector = Target;
+    MagnetTimeRemaining = FMath::Max(MagnetTimeRemaining, Duration);
+}
+
+void AWCollectibleField::ActivateMagnetInWorld(AActor* Target, float Duration)
+{
+    UWorld* World = Target ? Target->GetWorld() : nullptr;
+    if (!World)
+        return;
+
+    // Полей немного (по одному на секцию башни), поэтому простой перебор достаточен
+    for (TActorIterator<AWCollectibleField> It(World); It; ++It)
+    {
+        It->ActivateMagnet(Target, Duration);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+// ОБНОВЛЕНИЕ
+//----------------------------------------------------------------------------------------
+
+void AWCollectibleField::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    if (NumAlive == 0)
+        return;
+
+    // Без магнита сборщиком считается пешка игрока
+    if (!Collector.IsValid())
+    {
+        Collector = UGameplayStatics::GetPlayerPawn(this, 0);
+        if (!Collector.IsValid())
+            return;
+    }
+
+    const FVector CollectorLocation = Collector->GetActorLocation();
+    const bool bMagnetActive = MagnetTimeRemaining > 0.0f;
+    if (bMagnetActive)
+    {
+        MagnetTimeRemaining -= DeltaTime;
+    }
+
+    // Опрашиваем только ячейки, попадающие в радиус
+    QuerySphere(CollectorLocation, bMagnetActive ? MagnetRadius : CollectRadius, QueryScratch);
+
+    const float CollectRadiusSq = FMath::Square(CollectRadius);
+    for (int32 Item : QueryScratch)
+    {
+        if (FVector::DistSquared(Positions[Item], CollectorLocation) <= CollectRadiusSq)
+        {
+            Collect(Item);
+        }
+        else if (bMagnetActive && !AttractedFlags[Item])
+        {
+            AttractedFlags[Item] = true;
+            AttractedItems.Add(Item);
+        }
+    }
+
+    if (AttractedItems.Num() > 0)
+    {
+        if (bMagnetActive)
+        {
+            UpdateAttracted(CollectorLocation, DeltaTime);
+        }
+        else
+        {
+            // Магнит закончился: предметы остаются там, где их застало окончание действия
+            for (int32 Item : AttractedItems)
+            {
+                AttractedFlags[Item] = false;
+            }
+            AttractedItems.Reset();
+        }
+    }
+
+    FlushInstanceUpdates();
+}
+
+void AWCollectibleField::UpdateAttracted(const FVector& Target, float DeltaTime)
+{
+    const float Step = MagnetSpeed * DeltaTime;
+
+    for (int32 Index = AttractedItems.Num() - 1; Index >= 0; --Index)
+    {
+        const int32 Item = AttractedItems[Index];
+        if (!AliveFlags[Item])
+        {
+            AttractedItems.RemoveAtSwap(Index, 1, false);
+            continue;
+        }
+
+        FVector& Position = Positions[Item];
+        const FVector ToTarget = Target - Position;
+        const float Distance = ToTarget.Size();
+
+        if (Distance <= CollectRadius + Step)
+        {
+            AttractedItems.RemoveAtSwap(Index, 1, false);
+            Collect(Item);
+            continue;
+        }
+
+        Position += ToTarget * (Step / Distance);
+
+        // Переносим предмет в новую ячейку, только если он ее пересек
+        const FIntVector NewCell = GetCellCoord(Position);
+        if (NewCell != ItemCells[Item])
+        {
+            RemoveFromCell(Item, ItemCells[Item]);
+            InsertIntoCell(Item, NewCell);
+            ItemCells[Item] = NewCell;
+        }
+
+        // Обновляем трансформ без пометки рендера, пометим один раз в конце тика
+        GetInstancesForKind(Kinds[Item])->UpdateInstanceTransform(InstanceIndices[Item], FTransform(Position), true, false, true);
+        MarkInstancesDirty(Kinds[Item]);
+    }
+}
+
+void AWCollectibleField::Collect(int32 Item)
+{
+    if (!AliveFlags[Item])
+        return;
+
+    AliveFlags[Item] = false;
+    AttractedFlags[Item] = false;
+    RemoveFromCell(Item, ItemCells[Item]);
+    HideInstance(Item);
+    --NumAlive;
+
+    AActor* CollectorActor = Collector.Get();
+    switch (Kinds[Item])
+    {
+    case EWCollectibleKind::Coin:
+        if (AGameManager* GameManager = AGameManager::GetInstance(CollectorActor))
+        {
+            GameManager->UpdateScore(ScoreValues[Item]);
+        }
+        break;
+
+    case EWCollectibleKind::PowerUp:
+        if (PickupApplier && CollectorActor)
+        {
+            PickupApplier->PowerUpType = PowerUpTypes[Item];
+            PickupApplier->Duration = PowerUpDuration;
+            PickupApplier->Strength = PowerUpStrength;
+            PickupApplier->ApplyPowerUp(CollectorActor);
+        }
+        break;
+    }
+}
+
+void AWCollectibleField::HideInstance(int32 Item)
+{
+    // Индексы инстансов остаются стабильными: собранный предмет просто схлопывается
+    FTransform Hidden(Positions[Item]);
+    Hidden.SetScale3D(FVector::ZeroVector);
+    GetInstancesForKind(Kinds[Item])->UpdateInstanceTransform(InstanceIndices[Item], Hidden, true, false, true);
+    MarkInstancesDirty(Kinds[Item]);
+}
+
+void AWCollectibleField::MarkInstancesDirty(EWCollectibleKind Kind)
+{
+    if (Kind == EWCollectibleKind::Coin)
+    {
+        bCoinsRenderDirty = true;
+    }
+    else
+    {
+        bPowerUpsRenderDirty = true;
+    }
+}
+
+void AWCollectibleField::FlushInstanceUpdates()
+{
+    // Все изменения инстансов за тик уходят в рендер одной пометкой на компонент
+    if (bCoinsRenderDirty)
+    {
+        CoinInstances->MarkRenderStateDirty();
+        bCoinsRenderDirty = false;
+    }
+    if (bPowerUpsRenderDirty)
+    {
+        PowerUpInstances->MarkRenderStateDirty();
+        bPowerUpsRenderDirty = false;
+    }
+}
+
+//----------------------------------------------------------------------------------------
+// ПРОСТРАНСТВЕННЫЙ ХЕШ
+//----------------------------------------------------------------------------------------
+
+FIntVector AWCollectibleField::GetCellCoord(const FVector& Location) const
+{
+    return FIntVector(
+        FMath::FloorToInt(Location.X / CellSize),
+        FMath::FloorToInt(Location.Y / CellSize),
+        FMath::FloorToInt(Location.Z / CellSize));
+}
+
+void AWCollectibleField::InsertIntoCell(int32 Item, const FIntVector& Cell)
+{
+    Cells.FindOrAdd(Cell).Add(Item);
+}
+
+void AWCollectibleField::RemoveFromCell(int32 Item, const FIntVector& Cell)
+{
+    if (TArray<int32>* CellItems = Cells.Find(Cell))
+    {
+        CellItems->RemoveSingleSwap(Item, false);
+        if (CellItems->Num() == 0)
+        {
+            Cells.Remove(Cell);
+        }
+    }
+}
+
+void AWCollectibleField::QuerySphere(const FVector& Center, float Radius, TArray<int32>& OutItems) const
+{
+    OutItems.Reset();
+
+    const FIntVector MinCell = GetCellCoord(Center - FVector(Radius));
+    const FIntVector MaxCell = GetCellCoord(Center + FVector(Radius));
+    const float RadiusSq = FMath::Square(Radius);
+
+    for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+    {
+        for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+        {
+            for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+            {
+                const TArray<int32>* CellItems = Cells.Find(FIntVector(X, Y, Z));
+                if (!CellItems)
+                    continue;
+
+                for (int32 Item : *CellItems)
+                {
+                    if (FVector::DistSquared(Positions[Item], Center) <= RadiusSq)
+                    {
+                        OutItems.Add(Item);
+                    }
+                }
+            }
+        }
+    }
+}
+
+UInstancedStaticMeshComponent* AWCollectibleField::GetInstancesForKind(EWCollectibleKind Kind) const
+{
+    return Kind == EWCollectibleKind::Coin ? CoinInstances : PowerUpInstances;
+}
@@ -0,0 +1,182 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "../PowerUpComponent.h"
+#include "WCollectibleField.generated.h"
+
+class UInstancedStaticMeshComponent;
+
+// Вид предмета в поле
+UENUM(BlueprintType)
+enum class EWCollectibleKind : uint8
+{
+    Coin UMETA(DisplayName = "Coin"),
+    PowerUp UMETA(DisplayName = "Power-Up")
+};
+
+/**
+ * Описание одного предмета для размещения в поле
+ */
+USTRUCT(BlueprintType)
+struct FWCollectibleSpawn
+{
+    GENERATED_BODY()
+
+    // Положение в мировых координатах
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Предмет")
+    FVector Location;
+
+    // Вид предмета
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Предмет")
+    EWCollectibleKind Kind;
+
+    // Тип усиления (только для Kind == PowerUp)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Предмет")
+    EPowerUpType PowerUpType;
+
+    // Очки за подбор (только для Kind == Coin)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Предмет")
+    int32 ScoreValue;
+
+    FWCollectibleSpawn()
+        : Location(FVector::ZeroVector)
+        , Kind(EWCollectibleKind::Coin)
+        , PowerUpType(EPowerUpType::None)
+        , ScoreValue(1)
+    {
+    }
+};
+
+/**
+ * Поле собираемых предметов одной секции башни.
+ * Предметы хранятся в равномерном трехмерном пространственном хеше и рисуются
+ * через инстансированные меши, без отдельного актора и overlap-события на предмет.
+ * Пока активен магнит, опрашиваются только ячейки в радиусе действия,
+ * а притянутые предметы двигаются одним пакетным обновлением.
+ */
+UCLASS(Blueprintable)
+class WTOWER_API AWCollectibleField : public AActor
+{
+    GENERATED_BODY()
+
+public:
+    AWCollectibleField();
+
+    // Инстансированные меши для монет и усилений
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
+    UInstancedStaticMeshComponent* CoinInstances;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
+    UInstancedStaticMeshComponent* PowerUpInstances;
+
+    // Предметы, размещенные дизайнером
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Collectibles")
+    TArray<FWCollectibleSpawn> InitialCollectibles;
+
+    // Размер ячейки пространственного хеша
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Collectibles|Hash", meta = (ClampMin = "10.0"))
+    float CellSize;
+
+    // Радиус подбора предмета
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Collectibles")
+    float CollectRadius;
+
+    // Радиус действия магнита
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Collectibles|Magnet")
+    float MagnetRadius;
+
+    // Скорость притяжения предметов к игроку
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Collectibles|Magnet")
+    float MagnetSpeed;
+
+    // Параметры усилений, выдаваемых предметами
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Collectibles|Power-Up")
+    float PowerUpDuration;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Collectibles|Power-Up")
+    float PowerUpStrength;
+
+    // Добавить предмет в поле, возвращает его индекс
+    UFUNCTION(BlueprintCallable, Category = "Collectibles")
+    int32 AddCollectible(const FWCollectibleSpawn& Spawn);
+
+    // Удалить все предметы
+    UFUNCTION(BlueprintCallable, Category = "Collectibles")
+    void ClearCollectibles();
+
+    // Вернуть поле к размещению дизайнера и выключить магнит
+    UFUNCTION(BlueprintCallable, Category = "Collectibles")
+    void ResetCollectibles();
+
+    // Включить магнит для указанного сборщика
+    UFUNCTION(BlueprintCallable, Category = "Collectibles|Magnet")
+    void ActivateMagnet(AActor* Target, float Duration);
+
+    // Включить магнит во всех полях мира
+    static void ActivateMagnetInWorld(AActor* Target, float Duration);
+
+    // Количество еще не собранных предметов
+    UFUNCTION(BlueprintCallable, Category = "Collectibles")
+    int32 GetNumAlive() const { return NumAlive; }
+
+protected:
+    virtual void BeginPlay() override;
+    virtual void Tick(float DeltaTime) override;
+
+private:
+    //----------------------------------------------------------------------------------------
+    // ДАННЫЕ ПРЕДМЕТОВ (структура массивов, индекс = номер предмета)
+    //----------------------------------------------------------------------------------------
+
+    TArray<FVector> Positions;
+    TArray<FIntVector> ItemCells;
+    TArray<int32> InstanceIndices;
+    TArray<int32> ScoreValues;
+    TArray<EWCollectibleKind> Kinds;
+    TArray<EPowerUpType> PowerUpTypes;
+    TBitArray<> AliveFlags;
+    TBitArray<> AttractedFlags;
+
+    // Пространственный хеш: ячейка -> индексы предметов
+    TMap<FIntVector, TArray<int32>> Cells;
+
+    // Предметы, которые сейчас притягиваются магнитом
+    TArray<int32> AttractedItems;
+
+    // Временный буфер для результатов запроса
+    TArray<int32> QueryScratch;
+
+    int32 NumAlive;
+
+    // Сборщик и состояние магнита
+    TWeakObjectPtr<AActor> Collector;
+    float MagnetTimeRemaining;
+
+    // Инстансы изменены в этом тике, рендер еще не помечен
+    bool bCoinsRenderDirty;
+    bool bPowerUpsRenderDirty;
+
+    // Компонент, через который применяются усиления из предметов
+    UPROPERTY()
+    UPowerUpComponent* PickupApplier;
+
+    FIntVector GetCellCoord(const FVector& Location) const;
+    void InsertIntoCell(int32 Item, const FIntVector& Cell);
+    void RemoveFromCell(int32 Item, const FIntVector& Cell);
+
+    // Собрать индексы живых предметов в сфере
+    void QuerySphere(const FVector& Center, float Radius, TArray<int32>& OutItems) const;
+
+    // Пакетно сдвинуть притягиваемые предметы
+    void UpdateAttracted(const FVector& Target, float DeltaTime);
+
+    void Collect(int32 Item);
+    void HideInstance(int32 Item);
+
+    // Запомнить изменение инстансов вида / пометить рендер измененных компонентов
+    void MarkInstancesDirty(EWCollectibleKind Kind);
+    void FlushInstanceUpdates();
+
+    UInstancedStaticMeshComponent* GetInstancesForKind(EWCollectibleKind Kind) const;
+};
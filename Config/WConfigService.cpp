@@ -0,0 +1,313 @@
+#include "WConfigService.h"
+#include "../WTowerGameInstance.h"
+#include "Async/Async.h"
+#include "Hash/CityHash.h"
+#include "JsonObjectConverter.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+#if !UE_BUILD_SHIPPING
+#include "DirectoryWatcherModule.h"
+#include "IDirectoryWatcher.h"
+#include "Modules/ModuleManager.h"
+#endif
+
+UWConfigService::UWConfigService()
+{
+    // Инициализация по умолчанию
+    GameInstance = nullptr;
+    CurrentJsonHash = 0;
+    bLoadedFromSnapshot = false;
+}
+
+void UWConfigService::Initialize(UWTowerGameInstance* InGameInstance, const FString& InJsonPath)
+{
+    GameInstance = InGameInstance;
+    JsonPath = InJsonPath;
+    SnapshotPath = GetSnapshotPath(InJsonPath);
+}
+
+void UWConfigService::Shutdown()
+{
+#if !UE_BUILD_SHIPPING
+    if (WatchHandle.IsValid())
+    {
+        if (FDirectoryWatcherModule* Module = FModuleManager::GetModulePtr<FDirectoryWatcherModule>(TEXT("DirectoryWatcher")))
+        {
+            if (IDirectoryWatcher* Watcher = Module->Get())
+            {
+                Watcher->UnregisterDirectoryChangedCallback_Handle(FPaths::GetPath(JsonPath), WatchHandle);
+            }
+        }
+        WatchHandle.Reset();
+    }
+    FTSTicker::GetCoreTicker().RemoveTicker(WatcherTickHandle);
+#endif
+
+    if (PendingWrite.IsValid())
+    {
+        PendingWrite.Wait();
+    }
+}
+
+FString UWConfigService::GetSnapshotPath(const FString& InJsonPath)
+{
+    return FPaths::ChangeExtension(InJsonPath, TEXT("bin"));
+}
+
+//----------------------------------------------------------------------------------------
+// ЗАГРУЗКА
+//----------------------------------------------------------------------------------------
+
+FWConfigReadResult UWConfigService::ReadConfigFiles(const FString& InJsonPath)
+{
+    FWConfigReadResult Result;
+
+    TArray<uint8> JsonBytes;
+    if (!FFileHelper::LoadFileToArray(JsonBytes, *InJsonPath, FILEREAD_Silent))
+    {
+        return Result;
+    }
+
+    Result.bFileFound = true;
+    Result.JsonHash = HashJson(JsonBytes);
+
+    // Снимок подходит, только если совпадают формат, версия и хеш исходного JSON
+    TArray<uint8> SnapshotBytes;
+    if (FFileHelper::LoadFileToArray(SnapshotBytes, *GetSnapshotPath(InJsonPath), FILEREAD_Silent))
+    {
+        FMemoryReader Reader(SnapshotBytes);
+        uint32 Magic = 0;
+        uint32 Version = 0;
+        uint64 SourceHash = 0;
+        Reader << Magic << Version << SourceHash;
+
+        if (!Reader.IsError() && Magic == SnapshotMagic && Version == SnapshotVersion && SourceHash == Result.JsonHash)
+        {
+            const int64 HeaderSize = Reader.Tell();
+            Result.Snapshot = TArray<uint8>(SnapshotBytes.GetData() + HeaderSize, SnapshotBytes.Num() - HeaderSize);
+            return Result;
+        }
+    }
+
+    // Снимок устарел: разбираем JSON здесь же, пока мы не на игровом потоке
+    Result.Json = ParseJson(JsonBytes);
+    return Result;
+}
+
+bool UWConfigService::ApplyReadResult(UWTowerGameConfig* Config, const FWConfigReadResult& Result)
+{
+    bLoadedFromSnapshot = false;
+    if (!Config || !Result.bFileFound)
+    {
+        return false;
+    }
+
+    CurrentJsonHash = Result.JsonHash;
+
+    if (Result.Snapshot.Num() > 0)
+    {
+        FMemoryReader Reader(Result.Snapshot);
+        Config->SerializeSnapshot(Reader);
+        if (!Reader.IsError())
+        {
+            bLoadedFromSnapshot = true;
+            UE_LOG(LogTemp, Log, TEXT("WConfigService: Loaded config from snapshot"));
+            return true;
+        }
+        UE_LOG(LogTemp, Warning, TEXT("WConfigService: Snapshot is corrupted, falling back to JSON"));
+    }
+
+    TSharedPtr<FJsonObject> Json = Result.Json;
+    if (!Json.IsValid())
+    {
+        TArray<uint8> JsonBytes;
+        if (FFileHelper::LoadFileToArray(JsonBytes, *JsonPath, FILEREAD_Silent))
+        {
+            Json = ParseJson(JsonBytes);
+        }
+    }
+
+    if (!Json.IsValid())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("WConfigService: Failed to parse %s"), *JsonPath);
+        return false;
+    }
+
+    FJsonObjectConverter::JsonObjectToUStruct(Json.ToSharedRef(), Config->GetClass(), Config, 0, 0);
+    Config->SetInitialized(true);
+
+    // Следующий запуск прочитает снимок
+    WriteFilesAsync(TArray<uint8>(), MakeSnapshot(Config, CurrentJsonHash));
+    UE_LOG(LogTemp, Log, TEXT("WConfigService: Loaded config from JSON, snapshot refreshed"));
+    return true;
+}
+
+bool UWConfigService::LoadConfig(UWTowerGameConfig* Config)
+{
+    return ApplyReadResult(Config, ReadConfigFiles(JsonPath));
+}
+
+//----------------------------------------------------------------------------------------
+// СОХРАНЕНИЕ
+//----------------------------------------------------------------------------------------
+
+void UWConfigService::SaveConfig(UWTowerGameConfig* Config)
+{
+    if (!Config)
+        return;
+
+    // JSON пишем в UTF-8 сами, чтобы хеш считался по тем же байтам, что окажутся на диске
+    FString JsonString;
+    FJsonObjectConverter::UStructToJsonObjectString(Config->GetClass(), Config, JsonString, 0, 0);
+
+    FTCHARToUTF8 Utf8(*JsonString);
+    TArray<uint8> JsonBytes(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+
+    // Обновляем хеш до записи: собственное изменение файла не вызовет перезагрузку
+    CurrentJsonHash = HashJson(JsonBytes);
+    WriteFilesAsync(MoveTemp(JsonBytes), MakeSnapshot(Config, CurrentJsonHash));
+}
+
+TArray<uint8> UWConfigService::MakeSnapshot(UWTowerGameConfig* Config, uint64 JsonHash)
+{
+    TArray<uint8> Bytes;
+    FMemoryWriter Writer(Bytes);
+
+    uint32 Magic = SnapshotMagic;
+    uint32 Version = SnapshotVersion;
+    Writer << Magic << Version << JsonHash;
+    Config->SerializeSnapshot(Writer);
+
+    return Bytes;
+}
+
+void UWConfigService::WriteFilesAsync(TArray<uint8> JsonBytes, TArray<uint8> SnapshotBytes)
+{
+    // Записи выполняются по порядку: дожидаемся предыдущей
+    if (PendingWrite.IsValid())
+    {
+        PendingWrite.Wait();
+    }
+
+    PendingWrite = Async(EAsyncExecution::ThreadPool,
+        [JsonFile = JsonPath, SnapshotFile = SnapshotPath, JsonBytes = MoveTemp(JsonBytes), SnapshotBytes = MoveTemp(SnapshotBytes)]()
+        {
+            if (JsonBytes.Num() > 0 && !FFileHelper::SaveArrayToFile(JsonBytes, *JsonFile))
+            {
+                UE_LOG(LogTemp, Warning, TEXT("WConfigService: Failed to write %s"), *JsonFile);
+            }
+            if (SnapshotBytes.Num() > 0 && !FFileHelper::SaveArrayToFile(SnapshotBytes, *SnapshotFile))
+            {
+                UE_LOG(LogTemp, Warning, TEXT("WConfigService: Failed to write %s"), *SnapshotFile);
+            }
+        });
+}
+
+uint64 UWConfigService::HashJson(const TArray<uint8>& JsonBytes)
+{
+    return CityHash64(reinterpret_cast<const char*>(JsonBytes.GetData()), JsonBytes.Num());
+}
+
+TSharedPtr<FJsonObject> UWConfigService::ParseJson(const TArray<uint8>& JsonBytes)
+{
+    // BufferToString учитывает BOM и кодировку файла
+    FString JsonString;
+    FFileHelper::BufferToString(JsonString, JsonBytes.GetData(), JsonBytes.Num());
+
+    TSharedPtr<FJsonObject> JsonObject;
+    TSharedRef<TJsonReader<>> JsonReader = TJsonReaderFactory<>::Create(JsonString);
+    if (!FJsonSerializer::Deserialize(JsonReader, JsonObject) || !JsonObject.IsValid())
+    {
+        return nullptr;
+    }
+    return JsonObject;
+}
+
+//----------------------------------------------------------------------------------------
+// ГОРЯЧАЯ ПЕРЕЗАГРУЗКА
+//----------------------------------------------------------------------------------------
+
+void UWConfigService::StartWatching()
+{
+#if !UE_BUILD_SHIPPING
+    FDirectoryWatcherModule* Module = FModuleManager::LoadModulePtr<FDirectoryWatcherModule>(TEXT("DirectoryWatcher"));
+    IDirectoryWatcher* Watcher = Module ? Module->Get() : nullptr;
+    if (!Watcher || WatchHandle.IsValid())
+        return;
+
+    Watcher->RegisterDirectoryChangedCallback_Handle(
+        FPaths::GetPath(JsonPath),
+        IDirectoryWatcher::FDirectoryChanged::CreateUObject(this, &UWConfigService::OnConfigDirectoryChanged),
+        WatchHandle);
+
+#if !WITH_EDITOR
+    // В редакторе наблюдатель обновляет сам редактор, в игре - только мы
+    WatcherTickHandle = FTSTicker::GetCoreTicker().AddTicker(
+        FTickerDelegate::CreateWeakLambda(this, [Watcher](float DeltaTime)
+            {
+                Watcher->Tick(DeltaTime);
+                return true;
+            }),
+        0.25f);
+#endif
+
+    UE_LOG(LogTemp, Log, TEXT("WConfigService: Watching %s"), *JsonPath);
+#endif
+}
+
+void UWConfigService::OnConfigDirectoryChanged(const TArray<FFileChangeData>& Changes)
+{
+#if !UE_BUILD_SHIPPING
+    for (const FFileChangeData& Change : Changes)
+    {
+        if (Change.Action != FFileChangeData::FCA_Removed && FPaths::IsSamePath(Change.Filename, JsonPath))
+        {
+            ReloadChangedConfig();
+            return;
+        }
+    }
+#endif
+}
+
+void UWConfigService::ReloadChangedConfig()
+{
+    UWTowerGameConfig* Config = GameInstance ? GameInstance->GetGameConfig() : nullptr;
+    if (!Config)
+        return;
+
+    TArray<uint8> JsonBytes;
+    if (!FFileHelper::LoadFileToArray(JsonBytes, *JsonPath, FILEREAD_Silent))
+        return;
+
+    // Содержимое не изменилось (или это наша собственная запись)
+    const uint64 NewHash = HashJson(JsonBytes);
+    if (NewHash == CurrentJsonHash)
+        return;
+
+    TSharedPtr<FJsonObject> Json = ParseJson(JsonBytes);
+    if (!Json.IsValid())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("WConfigService: Ignoring invalid config edit in %s"), *JsonPath);
+        return;
+    }
+
+    // Запоминаем прежние значения, чтобы применить только изменившиеся разделы
+    const UWTowerGameConfig* Previous = DuplicateObject<UWTowerGameConfig>(Config, this);
+    FJsonObjectConverter::JsonObjectToUStruct(Json.ToSharedRef(), Config->GetClass(), Config, 0, 0);
+    const EWConfigSection Changed = Config->GetChangedSections(Previous);
+
+    CurrentJsonHash = NewHash;
+    WriteFilesAsync(TArray<uint8>(), MakeSnapshot(Config, CurrentJsonHash));
+
+    GameInstance->ApplySettingsSections(Changed);
+
+    UE_LOG(LogTemp, Log, TEXT("WConfigService: Hot reloaded config (graphics: %s, audio: %s, controls: %s)"),
+        EnumHasAnyFlags(Changed, EWConfigSection::Graphics) ? TEXT("yes") : TEXT("no"),
+        EnumHasAnyFlags(Changed, EWConfigSection::Audio) ? TEXT("yes") : TEXT("no"),
+        EnumHasAnyFlags(Changed, EWConfigSection::Controls) ? TEXT("yes") : TEXT("no"));
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "Containers/Ticker.h"
+#include "Async/Future.h"
+#include "Dom/JsonObject.h"
+#include "WTowerGameConfig.h"
+#include "WConfigService.generated.h"
+
+class UWTowerGameInstance;
+struct FFileChangeData;
+
+/**
+ * Результат чтения файлов настроек (заполняется на любом потоке)
+ */
+struct FWConfigReadResult
+{
+    // Найден ли файл JSON
+    bool bFileFound = false;
+
+    // Хеш содержимого JSON
+    uint64 JsonHash = 0;
+
+    // Данные снимка, если его хеш совпал с JSON
+    TArray<uint8> Snapshot;
+
+    // Разобранный JSON, если снимок устарел или отсутствует
+    TSharedPtr<FJsonObject> Json;
+};
+
+/**
+ * Сервис настроек игры.
+ * Рядом с GameConfig.json хранится версионированный двоичный снимок UWTowerGameConfig
+ * с хешем JSON, из которого он получен. Пока хеш совпадает, запуск читает снимок
+ * без разбора JSON через отражение. Вне shipping-сборок папка настроек отслеживается,
+ * и измененные разделы применяются сразу, без перезапуска.
+ */
+UCLASS()
+class WTOWER_API UWConfigService : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    UWConfigService();
+
+    // Инициализация сервиса для файла настроек
+    void Initialize(UWTowerGameInstance* InGameInstance, const FString& InJsonPath);
+
+    // Завершение работы (дожидается записи и снимает наблюдение)
+    void Shutdown();
+
+    // Прочитать JSON и снимок, проверить хеш, при необходимости разобрать JSON (любой поток)
+    static FWConfigReadResult ReadConfigFiles(const FString& JsonPath);
+
+    // Заполнить конфигурацию из результата чтения (игровой поток).
+    // Возвращает false, если файла нет и нужны настройки по умолчанию
+    bool ApplyReadResult(UWTowerGameConfig* Config, const FWConfigReadResult& Result);
+
+    // Прочитать и применить настройки синхронно
+    bool LoadConfig(UWTowerGameConfig* Config);
+
+    // Сохранить JSON и снимок (снимок делается сразу, запись на диск в фоне)
+    void SaveConfig(UWTowerGameConfig* Config);
+
+    // Начать отслеживание изменений файла настроек (не действует в shipping-сборке)
+    void StartWatching();
+
+    // Были ли настройки последний раз загружены из снимка
+    bool WasLoadedFromSnapshot() const { return bLoadedFromSnapshot; }
+
+    // Путь к снимку для файла JSON
+    static FString GetSnapshotPath(const FString& JsonPath);
+
+private:
+    static constexpr uint32 SnapshotMagic = 0x43475457; // "WTGC"
+    static constexpr uint32 SnapshotVersion = 1;
+
+    UPROPERTY()
+    UWTowerGameInstance* GameInstance;
+
+    FString JsonPath;
+    FString SnapshotPath;
+
+    // Хеш JSON, соответствующий текущим настройкам в памяти
+    uint64 CurrentJsonHash;
+    bool bLoadedFromSnapshot;
+
+    // Фоновая запись файлов
+    TFuture<void> PendingWrite;
+
+    // Наблюдение за папкой настроек
+    FDelegateHandle WatchHandle;
+    FTSTicker::FDelegateHandle WatcherTickHandle;
+
+    static uint64 HashJson(const TArray<uint8>& JsonBytes);
+    static TSharedPtr<FJsonObject> ParseJson(const TArray<uint8>& JsonBytes);
+
+    // Сделать снимок на игровом потоке
+    static TArray<uint8> MakeSnapshot(UWTowerGameConfig* Config, uint64 JsonHash);
+
+    // Записать файлы в фоне (пустой массив не записывается)
+    void WriteFilesAsync(TArray<uint8> JsonBytes, TArray<uint8> SnapshotBytes);
+
+    void OnConfigDirectoryChanged(const TArray<FFileChangeData>& Changes);
+
+    // Перечитать JSON и применить только изменившиеся разделы
+    void ReloadChangedConfig();
+};
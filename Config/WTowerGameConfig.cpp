@@ -91,6 +91,68 @@ void UWTowerGameConfig::ApplyGraphicsSettings()
     }
 }
 
+void UWTowerGameConfig::SerializeSnapshot(FArchive& Ar)
+{
+    // Графика
+    Ar << GraphicsQuality;
+    Ar << ScreenResolution;
+    Ar << bFullscreen;
+    Ar << bVSync;
+    Ar << MaxFPS;
+
+    // Звук
+    Ar << MasterVolume;
+    Ar << MusicVolume;
+    Ar << SFXVolume;
+    Ar << bMuteAudio;
+
+    // Управление
+    Ar << MouseSensitivity;
+    Ar << bInvertYAxis;
+    Ar << KeyBindings;
+
+    if (Ar.IsLoading())
+    {
+        bInitialized = true;
+    }
+}
+
+EWConfigSection UWTowerGameConfig::GetChangedSections(const UWTowerGameConfig* Other) const
+{
+    if (!Other)
+    {
+        return EWConfigSection::All;
+    }
+
+    EWConfigSection Changed = EWConfigSection::None;
+
+    if (GraphicsQuality != Other->GraphicsQuality
+        || ScreenResolution != Other->ScreenResolution
+        || bFullscreen != Other->bFullscreen
+        || bVSync != Other->bVSync
+        || MaxFPS != Other->MaxFPS)
+    {
+        Changed |= EWConfigSection::Graphics;
+    }
+
+    if (MasterVolume != Other->MasterVolume
+        || MusicVolume != Other->MusicVolume
+        || SFXVolume != Other->SFXVolume
+        || bMuteAudio != Other->bMuteAudio)
+    {
+        Changed |= EWConfigSection::Audio;
+    }
+
+    if (MouseSensitivity != Other->MouseSensitivity
+        || bInvertYAxis != Other->bInvertYAxis
+        || !KeyBindings.OrderIndependentCompareEqual(Other->KeyBindings))
+    {
+        Changed |= EWConfigSection::Controls;
+    }
+
+    return Changed;
+}
+
 TArray<FString> UWTowerGameConfig::GetAvailableResolutions() const
 {
     TArray<FString> Result;
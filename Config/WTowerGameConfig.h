@@ -4,6 +4,17 @@
 #include "UObject/NoExportTypes.h"
 #include "WTowerGameConfig.generated.h"
 
+// Разделы настроек (для выборочного применения изменений)
+enum class EWConfigSection : uint8
+{
+    None = 0,
+    Graphics = 1 << 0,
+    Audio = 1 << 1,
+    Controls = 1 << 2,
+    All = Graphics | Audio | Controls
+};
+ENUM_CLASS_FLAGS(EWConfigSection);
+
 /**
  * Класс для хранения конфигурации игры
  */
@@ -34,6 +45,13 @@ public:
     // Получить доступные разрешения экрана
     UFUNCTION(BlueprintCallable, Category = "Графика")
     TArray<FString> GetAvailableResolutions() const;
+
+    // Двоичный снимок всех настроек (для кэша конфигурации).
+    // При изменении набора полей нужно увеличить версию снимка в UWConfigService
+    void SerializeSnapshot(FArchive& Ar);
+
+    // Разделы, значения которых отличаются от другой конфигурации
+    EWConfigSection GetChangedSections(const UWTowerGameConfig* Other) const;
     
     //----------------------------------------------------------------------------------------
     // НАСТРОЙКИ ГРАФИКИ
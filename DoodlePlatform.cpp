@@ -6,12 +6,17 @@
 #include "BaruCharacter.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "PowerUpComponent.h"
+#include "Generation/WSpawnDistribution.h"
+#include "Gameplay/WTowerRunSubsystem.h"
+#include "WTowerStats.h"
+#include "WTowerMemory.h"
 #include "Materials/MaterialInstanceDynamic.h"
 #include "Engine/StaticMesh.h"
 #include "DrawDebugHelpers.h"
 
 ADoodlePlatform::ADoodlePlatform()
 {
+    LLM_SCOPE_BYTAG(Tower_Platforms);
     PrimaryActorTick.bCanEverTick = true;
 
     // Создаем корневой компонент
@@ -54,11 +59,16 @@ ADoodlePlatform::ADoodlePlatform()
     BreakDelay = 0.5f;
     BounceMultiplier = 1.5f;
     MovementDirection = 1.0f;
+    InitialScale = FVector::OneVector;
+    InitialPlatformType = EPlatformType::Normal;
 
     bHasPowerUp = false;
     PowerUpSpawnChance = 0.2f;
     PowerUpClass = nullptr;
 
+    SpawnDistribution = nullptr;
+    bRandomizeType = false;
+
     bShowDebugInfo = false;
 
     // Инициализация цветов
@@ -71,10 +81,14 @@ ADoodlePlatform::ADoodlePlatform()
 
 void ADoodlePlatform::BeginPlay()
 {
+    LLM_SCOPE_BYTAG(Tower_Platforms);
     Super::BeginPlay();
+    INC_DWORD_STAT(STAT_TowerLivePlatforms);
 
-    // Сохраняем начальную позицию для движущихся платформ
+    // Сохраняем начальное состояние для движущихся платформ и мягкого перезапуска
     InitialPosition = GetActorLocation();
+    InitialScale = PlatformMesh->GetRelativeScale3D();
+    InitialPlatformType = PlatformType;
 
     // Регистрируем обработчик события пересечения
     TopCollision->OnComponentBeginOverlap.AddDynamic(this, &ADoodlePlatform::OnPlayerLanded);
@@ -82,6 +96,9 @@ void ADoodlePlatform::BeginPlay()
     // Проверяем и инициализируем массивы материалов
     InitializeArrays();
 
+    // Выбираем тип платформы из распределения забега
+    ChooseRunPlatformType();
+
     // Обновляем внешний вид в зависимости от типа
     UpdateAppearance();
 
@@ -107,6 +124,62 @@ void ADoodlePlatform::BeginPlay()
     }
 }
 
+void ADoodlePlatform::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    DEC_DWORD_STAT(STAT_TowerLivePlatforms);
+    Super::EndPlay(EndPlayReason);
+}
+
+void ADoodlePlatform::ChooseRunPlatformType()
+{
+    if (SpawnDistribution && bRandomizeType)
+    {
+        if (UWTowerRunSubsystem* Run = GetWorld()->GetSubsystem<UWTowerRunSubsystem>())
+        {
+            PlatformType = SpawnDistribution->SamplePlatformType(InitialPosition.Z, Run->GetDifficulty(), Run->GetRunStream());
+        }
+    }
+}
+
+int32 ADoodlePlatform::GetActiveTimerCount() const
+{
+    const FTimerManager& TimerManager = GetWorldTimerManager();
+    return (TimerManager.IsTimerActive(ShakeTimerHandle) ? 1 : 0)
+        + (TimerManager.IsTimerActive(BreakTimerHandle) ? 1 : 0)
+        + (TimerManager.IsTimerActive(PowerUpAnimTimerHandle) ? 1 : 0);
+}
+
+void ADoodlePlatform::ResetPlatform()
+{
+    FTimerManager& TimerManager = GetWorldTimerManager();
+    TimerManager.ClearTimer(ShakeTimerHandle);
+    TimerManager.ClearTimer(BreakTimerHandle);
+    TimerManager.ClearTimer(PowerUpAnimTimerHandle);
+
+    // Возвращаем положение, масштаб и коллизию
+    SetActorLocation(InitialPosition);
+    MovementDirection = 1.0f;
+    PlatformMesh->SetRelativeScale3D(InitialScale);
+    PlatformMesh->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+    PlatformMesh->SetVisibility(true);
+    TopCollision->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+    SetActorTickEnabled(true);
+
+    // Тип и усиление выбираются заново из потока забега
+    PlatformType = InitialPlatformType;
+    ChooseRunPlatformType();
+    UpdateAppearance();
+
+    if (PowerUpMesh)
+    {
+        PowerUpMesh->SetVisibility(false);
+    }
+    if (bHasPowerUp && PowerUpClass)
+    {
+        SetupPowerUp();
+    }
+}
+
 void ADoodlePlatform::InitializeArrays()
 {
     // Убеждаемся, что у нас есть 4 цвета в массиве
@@ -129,6 +202,9 @@ void ADoodlePlatform::InitializeArrays()
 
 void ADoodlePlatform::UpdateAppearance()
 {
+    WTOWER_SCOPE_CYCLE(STAT_TowerPlatformAppearance);
+    LLM_SCOPE_BYTAG(Tower_Platforms);
+
     if (!PlatformMesh)
     {
         UE_LOG(LogTemp, Error, TEXT("Ошибка: PlatformMesh не существует"));
@@ -202,6 +278,7 @@ void ADoodlePlatform::UpdateAppearance()
 
 void ADoodlePlatform::SetPlatformColor(const FLinearColor& Color)
 {
+    LLM_SCOPE_BYTAG(Tower_Platforms);
     if (!PlatformMesh)
         return;
 
@@ -238,8 +315,11 @@ void ADoodlePlatform::SetPlatformColor(const FLinearColor& Color)
 }
 void ADoodlePlatform::Tick(float DeltaTime)
 {
+    WTOWER_SCOPE_TICK(STAT_TowerPlatformTick, Platforms);
     Super::Tick(DeltaTime);
 
+    INC_DWORD_STAT_BY(STAT_TowerActivePlatformTimers, GetActiveTimerCount());
+
     // Обрабатываем движущиеся платформы
     if (PlatformType == EPlatformType::Moving)
     {
@@ -265,6 +345,9 @@ void ADoodlePlatform::Tick(float DeltaTime)
 
 void ADoodlePlatform::OnPlayerLanded(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
 {
+    WTOWER_SCOPE_CYCLE(STAT_TowerPlatformLanded);
+    LLM_SCOPE_BYTAG(Tower_Platforms);
+
     // Проверяем, что приземлившийся актор - это персонаж игрока
     ABaruCharacter* Player = Cast<ABaruCharacter>(OtherActor);
     if (Player)
@@ -292,10 +375,7 @@ void ADoodlePlatform::OnPlayerLanded(UPrimitiveComponent* OverlappedComponent, A
                     DynMaterial->SetVectorParameterValue(TEXT("Color"), FLinearColor(1.0f, 0.2f, 0.2f));
                 }
 
-                // Добавляем покачивание платформы
-// Добавляем покачивание платформы
-                FTimerHandle ShakeTimerHandle;
-
+                // Добавляем покачивание платформы (таймер хранится, чтобы остановить его при разрушении)
                 // Для UE4 версий ниже 4.22
                 // auto WeakThis = MakeWeakObjectPtr<AActor>(this); 
 
@@ -325,8 +405,7 @@ void ADoodlePlatform::OnPlayerLanded(UPrimitiveComponent* OverlappedComponent, A
             if (GetWorld())
             {
                 UE_LOG(LogTemp, Display, TEXT("Breakable platform: Starting destruction sequence in %f seconds"), BreakDelay);
-                FTimerHandle TimerHandle;
-                GetWorld()->GetTimerManager().SetTimer(TimerHandle, this, &ADoodlePlatform::BreakPlatform, BreakDelay, false);
+                GetWorld()->GetTimerManager().SetTimer(BreakTimerHandle, this, &ADoodlePlatform::BreakPlatform, BreakDelay, false);
             }
             break;
 
@@ -407,20 +486,37 @@ void ADoodlePlatform::BreakPlatform()
     // Делаем платформу невидимой
     PlatformMesh->SetVisibility(false);
 
-    // Уничтожаем с задержкой, чтобы эффекты могли проиграться
-    SetLifeSpan(2.0f);
+    // Платформа не уничтожается, а остается в пуле до перезапуска забега
+    GetWorldTimerManager().ClearTimer(ShakeTimerHandle);
+    SetActorTickEnabled(false);
 }
 // Остальные методы остаются теми же, но добавляем проверки на nullptr...
 
 void ADoodlePlatform::SetupPowerUp()
 {
+    WTOWER_SCOPE_CYCLE(STAT_TowerPlatformSetupPowerUp);
+
+    // Компонент и материал усиления относятся к усилениям, а не к платформе
+    LLM_SCOPE_BYTAG(Tower_PowerUps);
+
     if (!PowerUpClass)
     {
         UE_LOG(LogTemp, Warning, TEXT("PowerUpClass не установлен в настройках платформы"));
         return;
     }
 
-    if (FMath::FRand() > PowerUpSpawnChance)
+    // Тип усиления берется из распределения, иначе используется простой шанс появления
+    EPowerUpType SampledType = EPowerUpType::None;
+    UWTowerRunSubsystem* Run = GetWorld()->GetSubsystem<UWTowerRunSubsystem>();
+    if (SpawnDistribution && Run)
+    {
+        SampledType = SpawnDistribution->SamplePowerUpType(InitialPosition.Z, Run->GetDifficulty(), Run->GetRunStream());
+        if (SampledType == EPowerUpType::None)
+        {
+            return;
+        }
+    }
+    else if (FMath::FRand() > PowerUpSpawnChance)
     {
         return;
     }
@@ -431,14 +527,32 @@ void ADoodlePlatform::SetupPowerUp()
         return;
     }
 
-    UPowerUpComponent* PowerUp = NewObject<UPowerUpComponent>(this, PowerUpClass);
+    // При перезапуске забега используем уже созданный компонент
+    UPowerUpComponent* PowerUp = FindComponentByClass<UPowerUpComponent>();
+    const bool bReused = PowerUp != nullptr;
+    if (!PowerUp)
+    {
+        PowerUp = NewObject<UPowerUpComponent>(this, PowerUpClass);
+    }
     if (!PowerUp)
     {
         UE_LOG(LogTemp, Error, TEXT("Не удалось создать PowerUpComponent"));
         return;
     }
 
-    PowerUp->RegisterComponent();
+    if (SampledType != EPowerUpType::None)
+    {
+        PowerUp->PowerUpType = SampledType;
+    }
+
+    if (bReused)
+    {
+        PowerUp->GlowColor = UPowerUpComponent::GetColorForPowerUpType(PowerUp->PowerUpType);
+    }
+    else
+    {
+        PowerUp->RegisterComponent();
+    }
 
     PowerUpMesh->SetVisibility(true);
 
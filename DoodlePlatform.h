@@ -8,6 +8,7 @@
 class UBoxComponent;
 class UStaticMeshComponent;
 class UPowerUpComponent;
+class UWSpawnDistribution;
 
 UENUM(BlueprintType)
 enum class EPlatformType : uint8
@@ -65,8 +66,26 @@ public:
     UPROPERTY(EditDefaultsOnly, Category = "PowerUp")
     TSubclassOf<UPowerUpComponent> PowerUpClass;
 
+    // Generation Settings
+    // Распределение типов платформ и усилений (если задано, заменяет PowerUpSpawnChance)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Platform|Generation")
+    UWSpawnDistribution* SpawnDistribution;
+
+    // Выбирать тип платформы из распределения вместо заданного вручную
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Platform|Generation")
+    bool bRandomizeType;
+
+    // Вернуть платформу в начальное состояние без пересоздания актора
+    // (тип заново выбирается из текущего потока забега, если включен bRandomizeType)
+    UFUNCTION(BlueprintCallable, Category = "Platform")
+    void ResetPlatform();
+
+    // Количество запущенных таймеров платформы (для оверлея производительности)
+    int32 GetActiveTimerCount() const;
+
 protected:
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
     virtual void Tick(float DeltaTime) override;
 
     UFUNCTION()
@@ -76,8 +95,12 @@ protected:
 
 private:
     FVector InitialPosition;
+    FVector InitialScale;
+    EPlatformType InitialPlatformType;
     float MovementDirection;
     FTimerHandle PowerUpAnimTimerHandle;
+    FTimerHandle ShakeTimerHandle;
+    FTimerHandle BreakTimerHandle;
 
     UPROPERTY()
     TArray<FLinearColor> PlatformColors;
@@ -89,6 +112,7 @@ private:
     void UpdateAppearance();
     void SetPlatformColor(const FLinearColor& Color);
     void SetupPowerUp();
+    void ChooseRunPlatformType();
     void AnimatePowerUp();
     void ActivatePowerUp(AActor* Activator);
     void BreakPlatform();
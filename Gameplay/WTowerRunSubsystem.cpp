@@ -0,0 +1,159 @@
+#include "WTowerRunSubsystem.h"
+#include "../WTowerGameState.h"
+#include "../WTowerStats.h"
+#include "../PlayerCharacter.h"
+#include "../DoodlePlatform.h"
+#include "../PowerUpActor.h"
+#include "../Collectibles/WCollectibleField.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/GameModeBase.h"
+
+void UWTowerRunSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    // По умолчанию каждый забег получает новое зерно
+    StartRun(FMath::Rand());
+}
+
+UWTowerRunSubsystem* UWTowerRunSubsystem::Get(const UObject* WorldContextObject)
+{
+    UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+    return World ? World->GetSubsystem<UWTowerRunSubsystem>() : nullptr;
+}
+
+TStatId UWTowerRunSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UWTowerRunSubsystem, STATGROUP_Tower);
+}
+
+void UWTowerRunSubsystem::StartRun(int32 Seed)
+{
+    RunSeed = Seed;
+    RunStream.Initialize(Seed);
+    ResetHeightTracking();
+    PowerUpMask = 0;
+    PowerUpCount = 0;
+
+    UE_LOG(LogTemp, Log, TEXT("WTowerRunSubsystem: Run started with seed %d"), Seed);
+}
+
+bool UWTowerRunSubsystem::SoftResetRun(bool bNewSeed)
+{
+    UWorld* World = GetWorld();
+    AWTowerGameState* GameState = GetTowerGameState();
+    AGameModeBase* GameMode = World->GetAuthGameMode();
+    if (!GameState || !GameMode)
+        return false;
+
+    // Нужен хотя бы один игрок на персонаже забега
+    APlayerController* PC = World->GetFirstPlayerController();
+    APlayerCharacter* Player = PC ? Cast<APlayerCharacter>(PC->GetPawn()) : nullptr;
+    if (!Player)
+        return false;
+
+    const double StartTime = FPlatformTime::Seconds();
+
+    // Поток забега перезапускается до сброса платформ, чтобы они выбрали те же типы при том же зерне
+    StartRun(bNewSeed ? FMath::Rand() : RunSeed);
+    GameState->ResetRunStats();
+
+    // Платформы, усиления и предметы возвращаются из пула, акторы не пересоздаются
+    for (TActorIterator<ADoodlePlatform> It(World); It; ++It)
+    {
+        It->ResetPlatform();
+    }
+    for (TActorIterator<APowerUpActor> It(World); It; ++It)
+    {
+        It->ResetPowerUp();
+    }
+    for (TActorIterator<AWCollectibleField> It(World); It; ++It)
+    {
+        It->ResetCollectibles();
+    }
+
+    // Игрок возвращается на точку старта
+    const AActor* PlayerStart = GameMode->FindPlayerStart(PC);
+    Player->ResetRunState(PlayerStart ? PlayerStart->GetActorTransform() : Player->GetActorTransform());
+
+    OnRunReset.Broadcast();
+
+    LastResetTimeMs = static_cast<float>((FPlatformTime::Seconds() - StartTime) * 1000.0);
+    SET_FLOAT_STAT(STAT_TowerSoftResetTime, LastResetTimeMs);
+    UE_LOG(LogTemp, Log, TEXT("WTowerRunSubsystem: Soft reset in %.2f ms (seed %d)"), LastResetTimeMs, RunSeed);
+    return true;
+}
+
+void UWTowerRunSubsystem::NotifyPowerUpUsed(EPowerUpType PowerUpType)
+{
+    PowerUpMask |= static_cast<uint16>(1u << static_cast<uint32>(PowerUpType));
+    ++PowerUpCount;
+}
+
+//----------------------------------------------------------------------------------------
+// ИГРОВОЕ СОСТОЯНИЕ И ВЫСОТА
+//----------------------------------------------------------------------------------------
+
+AWTowerGameState* UWTowerRunSubsystem::GetTowerGameState()
+{
+    if (!CachedGameState.IsValid())
+    {
+        CachedGameState = GetWorld()->GetGameState<AWTowerGameState>();
+    }
+    return CachedGameState.Get();
+}
+
+void UWTowerRunSubsystem::ReportPlayerHeight(float Height)
+{
+    const bool bFirst = !bHasPublishedHeight;
+    const bool bNewMax = bFirst || Height > MaxHeight;
+    const bool bQuantumStep = bFirst
+        || FMath::Abs(Height - PublishedHeight) >= HeightQuantum
+        || Height >= EventMaxHeight + HeightQuantum;
+    if (!bNewMax && !bQuantumStep)
+    {
+        return;
+    }
+
+    // Новый максимум передается в GameState сразу, чтобы вершина прыжка между шагами не терялась
+    if (AWTowerGameState* GameState = GetTowerGameState())
+    {
+        GameState->UpdatePlayerHeight(Height);
+    }
+    MaxHeight = bNewMax ? Height : MaxHeight;
+
+    // Подписчики получают высоту с шагом HeightQuantum, иначе при подъеме событие шло бы каждый кадр
+    if (!bQuantumStep)
+    {
+        return;
+    }
+
+    // Одно событие за кадр, сколько бы раз ни менялась высота
+    bPendingNewMax |= bFirst || MaxHeight > EventMaxHeight;
+    PublishedHeight = Height;
+    EventMaxHeight = MaxHeight;
+    bHasPublishedHeight = true;
+    bHeightEventPending = true;
+}
+
+void UWTowerRunSubsystem::Tick(float DeltaTime)
+{
+    if (bHeightEventPending)
+    {
+        const bool bNewMax = bPendingNewMax;
+        bHeightEventPending = false;
+        bPendingNewMax = false;
+        OnHeightChanged.Broadcast(PublishedHeight, MaxHeight, bNewMax);
+    }
+}
+
+void UWTowerRunSubsystem::ResetHeightTracking()
+{
+    PublishedHeight = 0.0f;
+    MaxHeight = 0.0f;
+    EventMaxHeight = 0.0f;
+    bHasPublishedHeight = false;
+    bHeightEventPending = false;
+    bPendingNewMax = false;
+}
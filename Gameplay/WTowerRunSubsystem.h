@@ -0,0 +1,125 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Math/RandomStream.h"
+#include "../PowerUpComponent.h"
+#include "WTowerRunSubsystem.generated.h"
+
+class AWTowerGameState;
+
+// Изменение высоты игрока (текущая высота, максимальная высота, поставлен ли новый рекорд)
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnWTowerHeightChanged, float /*CurrentHeight*/, float /*MaxHeight*/, bool /*bNewMax*/);
+
+// Забег возвращен в начальное состояние без перезагрузки карты
+DECLARE_MULTICAST_DELEGATE(FOnWTowerRunReset);
+
+/**
+ * Состояние текущего забега в мире: зерно генерации, сложность и высота игрока.
+ * Все случайные решения генерации берутся из одного потока, чтобы забег
+ * можно было воспроизвести по зерну.
+ */
+UCLASS()
+class WTOWER_API UWTowerRunSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    // Получить подсистему забега для мира объекта
+    static UWTowerRunSubsystem* Get(const UObject* WorldContextObject);
+
+    //----------------------------------------------------------------------------------------
+    // ЗАБЕГ
+    //----------------------------------------------------------------------------------------
+
+    // Начать забег с указанным зерном
+    UFUNCTION(BlueprintCallable, Category = "Забег")
+    void StartRun(int32 Seed);
+
+    // Вернуть забег в начальное состояние на месте: счет, время, высота, игрок на старте,
+    // платформы и усиления из пула, генерация с тем же или новым зерном.
+    // Возвращает false, если в мире нет забега (например, в меню)
+    UFUNCTION(BlueprintCallable, Category = "Забег")
+    bool SoftResetRun(bool bNewSeed);
+
+    // Длительность последнего мягкого перезапуска (мс)
+    UFUNCTION(BlueprintCallable, Category = "Забег")
+    float GetLastResetTimeMs() const { return LastResetTimeMs; }
+
+    // Вызывается после мягкого перезапуска
+    FOnWTowerRunReset OnRunReset;
+
+    // Отметить подобранное усиление (для истории забегов)
+    void NotifyPowerUpUsed(EPowerUpType PowerUpType);
+
+    // Битовая маска и количество усилений, подобранных в забеге
+    uint16 GetPowerUpMask() const { return PowerUpMask; }
+    int32 GetPowerUpCount() const { return PowerUpCount; }
+
+    // Зерно текущего забега
+    UFUNCTION(BlueprintCallable, Category = "Забег")
+    int32 GetRunSeed() const { return RunSeed; }
+
+    // Поток случайных чисел забега
+    const FRandomStream& GetRunStream() const { return RunStream; }
+
+    // Сложность текущего забега
+    UFUNCTION(BlueprintCallable, Category = "Забег")
+    int32 GetDifficulty() const { return Difficulty; }
+
+    UFUNCTION(BlueprintCallable, Category = "Забег")
+    void SetDifficulty(int32 NewDifficulty) { Difficulty = NewDifficulty; }
+
+    //----------------------------------------------------------------------------------------
+    // ИГРОВОЕ СОСТОЯНИЕ И ВЫСОТА
+    //----------------------------------------------------------------------------------------
+
+    // Типизированный GameState, приведение выполняется один раз
+    AWTowerGameState* GetTowerGameState();
+
+    // Сообщить текущую высоту игрока. В GameState передается, если высота сместилась на HeightQuantum
+    // или установлен новый максимум; событие OnHeightChanged - только при смещении на HeightQuantum
+    // от опубликованной высоты или максимума
+    void ReportPlayerHeight(float Height);
+
+    // Шаг публикации высоты
+    UFUNCTION(BlueprintCallable, Category = "Забег|Высота")
+    void SetHeightQuantum(float NewQuantum) { HeightQuantum = FMath::Max(NewQuantum, 0.0f); }
+
+    UFUNCTION(BlueprintCallable, Category = "Забег|Высота")
+    float GetPublishedHeight() const { return PublishedHeight; }
+
+    UFUNCTION(BlueprintCallable, Category = "Забег|Высота")
+    float GetMaxHeight() const { return MaxHeight; }
+
+    // Событие изменения высоты, не чаще одного раза за кадр
+    FOnWTowerHeightChanged OnHeightChanged;
+
+private:
+    int32 RunSeed = 0;
+    int32 Difficulty = 0;
+    FRandomStream RunStream;
+    float LastResetTimeMs = 0.0f;
+
+    // Усиления, подобранные в текущем забеге
+    uint16 PowerUpMask = 0;
+    int32 PowerUpCount = 0;
+
+    // Кэшированный GameState
+    TWeakObjectPtr<AWTowerGameState> CachedGameState;
+
+    // Состояние отслеживания высоты
+    float HeightQuantum = 10.0f;
+    float PublishedHeight = 0.0f;
+    float MaxHeight = 0.0f;
+    float EventMaxHeight = 0.0f;
+    bool bHasPublishedHeight = false;
+    bool bHeightEventPending = false;
+    bool bPendingNewMax = false;
+
+    void ResetHeightTracking();
+};
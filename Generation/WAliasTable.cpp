@@ -0,0 +1,66 @@
+#include "WAliasTable.h"
+
+void FWAliasTable::Build(TArrayView<const float> Weights)
+{
+    Reset();
+
+    const int32 Count = Weights.Num();
+    double Total = 0.0;
+    for (float Weight : Weights)
+    {
+        Total += FMath::Max(Weight, 0.0f);
+    }
+
+    if (Count == 0 || Total <= 0.0)
+    {
+        return;
+    }
+
+    Probabilities.SetNumUninitialized(Count);
+    Aliases.SetNumUninitialized(Count);
+
+    // Масштабируем веса так, чтобы среднее было равно 1
+    TArray<double> Scaled;
+    Scaled.SetNumUninitialized(Count);
+
+    TArray<int32> Small;
+    TArray<int32> Large;
+    Small.Reserve(Count);
+    Large.Reserve(Count);
+
+    for (int32 Index = 0; Index < Count; ++Index)
+    {
+        Scaled[Index] = FMath::Max(Weights[Index], 0.0f) * Count / Total;
+        Aliases[Index] = Index;
+        (Scaled[Index] < 1.0 ? Small : Large).Add(Index);
+    }
+
+    // Заполняем недостающую часть малых столбцов излишком больших
+    while (Small.Num() > 0 && Large.Num() > 0)
+    {
+        const int32 Less = Small.Pop(false);
+        const int32 More = Large.Pop(false);
+
+        Probabilities[Less] = static_cast<float>(Scaled[Less]);
+        Aliases[Less] = More;
+
+        Scaled[More] = (Scaled[More] + Scaled[Less]) - 1.0;
+        (Scaled[More] < 1.0 ? Small : Large).Add(More);
+    }
+
+    // Остатки из-за погрешности округления считаем полными столбцами
+    for (int32 Index : Large)
+    {
+        Probabilities[Index] = 1.0f;
+    }
+    for (int32 Index : Small)
+    {
+        Probabilities[Index] = 1.0f;
+    }
+}
+
+void FWAliasTable::Reset()
+{
+    Probabilities.Reset();
+    Aliases.Reset();
+}
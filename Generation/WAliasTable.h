@@ -0,0 +1,44 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Math/RandomStream.h"
+
+/**
+ * Таблица Уолкера (alias method) для выборки из дискретного распределения за O(1).
+ * Построение занимает O(N), каждая выборка - одно случайное число и одно сравнение.
+ */
+struct WTOWER_API FWAliasTable
+{
+public:
+    // Построить таблицу по весам (отрицательные веса считаются нулевыми)
+    void Build(TArrayView<const float> Weights);
+
+    // Очистить таблицу
+    void Reset();
+
+    // Таблица пуста, если все веса были нулевыми
+    bool IsEmpty() const { return Probabilities.Num() == 0; }
+
+    int32 Num() const { return Probabilities.Num(); }
+
+    // Выбрать индекс исхода по одному равномерному числу из [0, 1)
+    FORCEINLINE int32 SampleUniform(float Uniform) const
+    {
+        const float Scaled = Uniform * Probabilities.Num();
+        const int32 Column = FMath::Min(static_cast<int32>(Scaled), Probabilities.Num() - 1);
+        return (Scaled - Column) < Probabilities[Column] ? Column : Aliases[Column];
+    }
+
+    // Выбрать индекс исхода из потока случайных чисел
+    FORCEINLINE int32 Sample(const FRandomStream& Stream) const
+    {
+        return SampleUniform(Stream.GetFraction());
+    }
+
+private:
+    // Вероятность оставить столбец (иначе берется его псевдоним)
+    TArray<float> Probabilities;
+
+    // Псевдонимы столбцов
+    TArray<int32> Aliases;
+};
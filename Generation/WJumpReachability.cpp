@@ -0,0 +1,237 @@
+#include "WJumpReachability.h"
+#include "../PowerUpComponent.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "Algo/Sort.h"
+#include "Algo/BinarySearch.h"
+
+const FName UWJumpReachability::DefaultProfile(TEXT("Default"));
+const FName UWJumpReachability::JumpBoostProfile(TEXT("JumpBoost"));
+const FName UWJumpReachability::SlowFallProfile(TEXT("SlowFall"));
+
+//----------------------------------------------------------------------------------------
+// ТАБЛИЦА ОГИБАЮЩЕЙ
+//----------------------------------------------------------------------------------------
+
+void FWReachabilityTable::Build(const FWMovementProfile& Profile)
+{
+    SourceProfile = Profile;
+
+    const float Velocity = Profile.JumpVelocity * Profile.JumpMultiplier;
+    const float Gravity = FMath::Max(Profile.WorldGravity * Profile.GravityScale * Profile.GravityMultiplier, KINDA_SMALL_NUMBER);
+    const float Acceleration = FMath::Max(Profile.MaxAcceleration * Profile.AirControl, KINDA_SMALL_NUMBER);
+    const float MaxSpeed = Profile.MaxWalkSpeed * Profile.SpeedMultiplier;
+    const float TimeToMaxSpeed = MaxSpeed / Acceleration;
+
+    ApexHeight = FMath::Square(Velocity) / (2.0f * Gravity);
+    Tolerance = Profile.LandingTolerance;
+
+    const int32 NumBuckets = FMath::FloorToInt((MaxDrop + ApexHeight) / HeightStep) + 1;
+    MaxHorizontalSq.SetNumUninitialized(NumBuckets);
+
+    for (int32 Bucket = 0; Bucket < NumBuckets; ++Bucket)
+    {
+        const float DeltaZ = FMath::Min(-MaxDrop + Bucket * HeightStep, ApexHeight);
+
+        // Время до приземления на высоте DeltaZ на нисходящей части траектории
+        const float Discriminant = FMath::Max(FMath::Square(Velocity) - 2.0f * Gravity * DeltaZ, 0.0f);
+        const float AirTime = (Velocity + FMath::Sqrt(Discriminant)) / Gravity;
+
+        // Прыжок начинается с нулевой горизонтальной скоростью (см. PerformJump),
+        // дальше персонаж разгоняется управлением в воздухе до MaxWalkSpeed
+        const float Horizontal = AirTime <= TimeToMaxSpeed
+            ? 0.5f * Acceleration * FMath::Square(AirTime)
+            : 0.5f * MaxSpeed * TimeToMaxSpeed + MaxSpeed * (AirTime - TimeToMaxSpeed);
+
+        MaxHorizontalSq[Bucket] = FMath::Square(Horizontal + Tolerance);
+    }
+}
+
+bool FWReachabilityTable::CanReach(const FVector& From, const FVector& To) const
+{
+    const float DeltaZ = To.Z - From.Z;
+    if (DeltaZ > ApexHeight || DeltaZ < -MaxDrop || MaxHorizontalSq.Num() == 0)
+    {
+        return false;
+    }
+
+    // Округляем вверх: большая высота дает меньшую дальность, поэтому оценка консервативна
+    const int32 Bucket = FMath::Min(FMath::CeilToInt((DeltaZ + MaxDrop) / HeightStep), MaxHorizontalSq.Num() - 1);
+    return FVector::DistSquaredXY(From, To) <= MaxHorizontalSq[Bucket];
+}
+
+//----------------------------------------------------------------------------------------
+// ПРОФИЛИ
+//----------------------------------------------------------------------------------------
+
+void UWJumpReachability::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    FWMovementProfile Default;
+    RegisterProfile(DefaultProfile, Default);
+
+    // Множители считаются так же, как при применении усиления с силой по умолчанию
+    const float DefaultStrength = GetDefault<UPowerUpComponent>()->Strength;
+
+    FWMovementProfile JumpBoost = Default;
+    JumpBoost.JumpMultiplier = UPowerUpComponent::GetJumpBoostMultiplier(DefaultStrength);
+    RegisterProfile(JumpBoostProfile, JumpBoost);
+
+    FWMovementProfile SlowFall = Default;
+    SlowFall.GravityMultiplier = UPowerUpComponent::GetSlowFallGravityScale(DefaultStrength);
+    RegisterProfile(SlowFallProfile, SlowFall);
+}
+
+void UWJumpReachability::RegisterProfile(FName ProfileName, const FWMovementProfile& Profile)
+{
+    if (const TSharedRef<const FWReachabilityTable, ESPMode::ThreadSafe>* Existing = Tables.Find(ProfileName))
+    {
+        if (FWMovementProfile::StaticStruct()->CompareScriptStruct(&(*Existing)->SourceProfile, &Profile, 0))
+        {
+            return;
+        }
+    }
+
+    // Старая таблица остается живой, пока ее используют фоновые проверки
+    TSharedRef<FWReachabilityTable, ESPMode::ThreadSafe> Table = MakeShared<FWReachabilityTable, ESPMode::ThreadSafe>();
+    Table->Build(Profile);
+    Tables.Add(ProfileName, Table);
+
+    UE_LOG(LogTemp, Log, TEXT("WJumpReachability: Built table for profile %s (apex %.0f)"), *ProfileName.ToString(), Table->GetApexHeight());
+}
+
+TSharedPtr<const FWReachabilityTable, ESPMode::ThreadSafe> UWJumpReachability::FindTable(FName Profile) const
+{
+    if (const TSharedRef<const FWReachabilityTable, ESPMode::ThreadSafe>* Table = Tables.Find(Profile))
+    {
+        return *Table;
+    }
+
+    UE_LOG(LogTemp, Warning, TEXT("WJumpReachability: Unknown movement profile %s"), *Profile.ToString());
+    return nullptr;
+}
+
+bool UWJumpReachability::CanReach(const FVector& From, const FVector& To, FName Profile) const
+{
+    if (const TSharedRef<const FWReachabilityTable, ESPMode::ThreadSafe>* Table = Tables.Find(Profile))
+    {
+        return (*Table)->CanReach(From, To);
+    }
+    return false;
+}
+
+//----------------------------------------------------------------------------------------
+// ПРОВЕРКА УЧАСТКА
+//----------------------------------------------------------------------------------------
+
+FWChunkValidationResult UWJumpReachability::ValidateChunk(const TArray<FVector>& Platforms, int32 StartIndex, FName Profile) const
+{
+    TSharedPtr<const FWReachabilityTable, ESPMode::ThreadSafe> Table = FindTable(Profile);
+    if (!Table.IsValid())
+    {
+        return FWChunkValidationResult();
+    }
+    return ValidateWithTable(*Table, Platforms, StartIndex);
+}
+
+void UWJumpReachability::ValidateChunkAsync(TArray<FVector> Platforms, int32 StartIndex, FName Profile,
+    TFunction<void(const FWChunkValidationResult&)> OnComplete) const
+{
+    TSharedPtr<const FWReachabilityTable, ESPMode::ThreadSafe> Table = FindTable(Profile);
+    if (!Table.IsValid())
+    {
+        OnComplete(FWChunkValidationResult());
+        return;
+    }
+
+    Async(EAsyncExecution::ThreadPool, [Table, Platforms = MoveTemp(Platforms), StartIndex, OnComplete = MoveTemp(OnComplete)]()
+    {
+        FWChunkValidationResult Result = ValidateWithTable(*Table, Platforms, StartIndex);
+
+        AsyncTask(ENamedThreads::GameThread, [Result = MoveTemp(Result), OnComplete]()
+        {
+            OnComplete(Result);
+        });
+    });
+}
+
+FWChunkValidationResult UWJumpReachability::ValidateWithTable(const FWReachabilityTable& Table, const TArray<FVector>& Platforms, int32 StartIndex)
+{
+    FWChunkValidationResult Result;
+    const double StartTime = FPlatformTime::Seconds();
+
+    const int32 NumPlatforms = Platforms.Num();
+    if (!Platforms.IsValidIndex(StartIndex))
+    {
+        return Result;
+    }
+
+    // Сортируем по высоте, чтобы для каждой платформы смотреть только окно достижимых высот
+    TArray<int32> ByHeight;
+    ByHeight.SetNumUninitialized(NumPlatforms);
+    for (int32 Index = 0; Index < NumPlatforms; ++Index)
+    {
+        ByHeight[Index] = Index;
+    }
+    Algo::SortBy(ByHeight, [&Platforms](int32 Index) { return Platforms[Index].Z; });
+
+    TArray<float> SortedHeights;
+    SortedHeights.SetNumUninitialized(NumPlatforms);
+    for (int32 Rank = 0; Rank < NumPlatforms; ++Rank)
+    {
+        SortedHeights[Rank] = Platforms[ByHeight[Rank]].Z;
+    }
+
+    // Каждая платформа пишет только в свой список переходов
+    TArray<TArray<int32>> Edges;
+    Edges.SetNum(NumPlatforms);
+
+    ParallelFor(NumPlatforms, [&](int32 From)
+    {
+        const FVector& FromLocation = Platforms[From];
+        const int32 First = Algo::LowerBound(SortedHeights, FromLocation.Z - FWReachabilityTable::MaxDrop);
+        const int32 Last = Algo::UpperBound(SortedHeights, FromLocation.Z + Table.GetApexHeight());
+
+        for (int32 Rank = First; Rank < Last; ++Rank)
+        {
+            const int32 To = ByHeight[Rank];
+            if (To != From && Table.CanReach(FromLocation, Platforms[To]))
+            {
+                Edges[From].Add(To);
+            }
+        }
+    });
+
+    // Обход в ширину от стартовой платформы
+    TBitArray<> Visited(false, NumPlatforms);
+    TArray<int32> Queue;
+    Queue.Reserve(NumPlatforms);
+    Queue.Add(StartIndex);
+    Visited[StartIndex] = true;
+
+    for (int32 Head = 0; Head < Queue.Num(); ++Head)
+    {
+        for (int32 Next : Edges[Queue[Head]])
+        {
+            if (!Visited[Next])
+            {
+                Visited[Next] = true;
+                Queue.Add(Next);
+            }
+        }
+    }
+
+    for (int32 Index = 0; Index < NumPlatforms; ++Index)
+    {
+        Result.NumEdges += Edges[Index].Num();
+        if (!Visited[Index])
+        {
+            Result.UnreachablePlatforms.Add(Index);
+        }
+    }
+
+    Result.bValid = Result.UnreachablePlatforms.Num() == 0;
+    Result.ValidationTimeMs = static_cast<float>((FPlatformTime::Seconds() - StartTime) * 1000.0);
+    return Result;
+}
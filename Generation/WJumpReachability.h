@@ -0,0 +1,160 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "WJumpReachability.generated.h"
+
+/**
+ * Параметры движения, от которых зависит дальность прыжка.
+ * Значения по умолчанию совпадают с настройками APlayerCharacter.
+ */
+USTRUCT(BlueprintType)
+struct FWMovementProfile
+{
+    GENERATED_BODY()
+
+    // Вертикальная скорость отскока (JumpPower)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Движение")
+    float JumpVelocity;
+
+    // Гравитация мира (по модулю) и ее множитель у персонажа
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Движение")
+    float WorldGravity;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Движение")
+    float GravityScale;
+
+    // Управление в воздухе
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Движение")
+    float AirControl;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Движение")
+    float MaxWalkSpeed;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Движение")
+    float MaxAcceleration;
+
+    // Модификаторы активных усилений (ActivateJumpBoost, ActivateSlowFall, ActivateSpeedBoost)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Модификаторы")
+    float JumpMultiplier;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Модификаторы")
+    float GravityMultiplier;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Модификаторы")
+    float SpeedMultiplier;
+
+    // Допуск по горизонтали (половина ширины платформы)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Движение")
+    float LandingTolerance;
+
+    FWMovementProfile()
+        : JumpVelocity(850.0f)
+        , WorldGravity(980.0f)
+        , GravityScale(1.8f)
+        , AirControl(0.8f)
+        , MaxWalkSpeed(600.0f)
+        , MaxAcceleration(2048.0f)
+        , JumpMultiplier(1.0f)
+        , GravityMultiplier(1.0f)
+        , SpeedMultiplier(1.0f)
+        , LandingTolerance(50.0f)
+    {
+    }
+};
+
+/**
+ * Результат проверки сгенерированного участка башни
+ */
+USTRUCT(BlueprintType)
+struct FWChunkValidationResult
+{
+    GENERATED_BODY()
+
+    // Все платформы достижимы из стартовой
+    UPROPERTY(BlueprintReadOnly, Category = "Достижимость")
+    bool bValid = false;
+
+    // Индексы недостижимых платформ
+    UPROPERTY(BlueprintReadOnly, Category = "Достижимость")
+    TArray<int32> UnreachablePlatforms;
+
+    // Количество найденных переходов между платформами
+    UPROPERTY(BlueprintReadOnly, Category = "Достижимость")
+    int32 NumEdges = 0;
+
+    // Время проверки
+    UPROPERTY(BlueprintReadOnly, Category = "Достижимость")
+    float ValidationTimeMs = 0.0f;
+};
+
+/**
+ * Таблица огибающей прыжка для одного профиля: максимальная дальность по горизонтали
+ * для каждого перепада высоты. Неизменяема после построения, поэтому безопасна
+ * для чтения из рабочих потоков.
+ */
+struct WTOWER_API FWReachabilityTable
+{
+    // Шаг таблицы по высоте
+    static constexpr float HeightStep = 10.0f;
+
+    // Самый большой учитываемый спуск
+    static constexpr float MaxDrop = 4000.0f;
+
+    void Build(const FWMovementProfile& Profile);
+
+    // Можно ли допрыгнуть из From в To
+    bool CanReach(const FVector& From, const FVector& To) const;
+
+    // Высота вершины прыжка
+    float GetApexHeight() const { return ApexHeight; }
+
+    FWMovementProfile SourceProfile;
+
+private:
+    float ApexHeight = 0.0f;
+    float Tolerance = 0.0f;
+
+    // Квадрат дальности по горизонтали, индекс = (DeltaZ + MaxDrop) / HeightStep
+    TArray<float> MaxHorizontalSq;
+};
+
+/**
+ * Модуль достижимости прыжков: таблицы огибающих для каждого профиля движения,
+ * быстрые запросы CanReach и параллельная проверка целого участка башни
+ * на рабочих потоках до того, как он будет принят.
+ */
+UCLASS()
+class WTOWER_API UWJumpReachability : public UGameInstanceSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    // Имена стандартных профилей
+    static const FName DefaultProfile;
+    static const FName JumpBoostProfile;
+    static const FName SlowFallProfile;
+
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+    // Зарегистрировать профиль (таблица перестраивается, только если параметры изменились)
+    void RegisterProfile(FName ProfileName, const FWMovementProfile& Profile);
+
+    // Можно ли допрыгнуть из From в To с указанным профилем
+    UFUNCTION(BlueprintCallable, Category = "Достижимость")
+    bool CanReach(const FVector& From, const FVector& To, FName Profile) const;
+
+    // Проверить участок на текущем потоке (платформы обрабатываются параллельно)
+    FWChunkValidationResult ValidateChunk(const TArray<FVector>& Platforms, int32 StartIndex, FName Profile) const;
+
+    // Проверить участок в фоне, результат придет на игровом потоке
+    void ValidateChunkAsync(TArray<FVector> Platforms, int32 StartIndex, FName Profile,
+        TFunction<void(const FWChunkValidationResult&)> OnComplete) const;
+
+private:
+    TMap<FName, TSharedRef<const FWReachabilityTable, ESPMode::ThreadSafe>> Tables;
+
+    TSharedPtr<const FWReachabilityTable, ESPMode::ThreadSafe> FindTable(FName Profile) const;
+
+    static FWChunkValidationResult ValidateWithTable(const FWReachabilityTable& Table, const TArray<FVector>& Platforms, int32 StartIndex);
+};
@@ -0,0 +1,168 @@
+#include "WSpawnDistribution.h"
+#include "Algo/Sort.h"
+#include "Algo/BinarySearch.h"
+
+void UWSpawnDistribution::PostLoad()
+{
+    Super::PostLoad();
+    bTablesDirty = true;
+}
+
+#if WITH_EDITOR
+void UWSpawnDistribution::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+    Super::PostEditChangeProperty(PropertyChangedEvent);
+    bTablesDirty = true;
+}
+#endif
+
+void UWSpawnDistribution::SetBands(const TArray<FWSpawnBand>& NewBands)
+{
+    Bands = NewBands;
+    bTablesDirty = true;
+}
+
+//----------------------------------------------------------------------------------------
+// ВЫБОРКА
+//----------------------------------------------------------------------------------------
+
+EPlatformType UWSpawnDistribution::SamplePlatformType(float Height, int32 Difficulty, const FRandomStream& Stream) const
+{
+    const FCompiledBand* Band = FindBand(Height, Difficulty);
+    if (!Band || Band->PlatformTable.IsEmpty())
+    {
+        return EPlatformType::Normal;
+    }
+    return Band->PlatformValues[Band->PlatformTable.Sample(Stream)];
+}
+
+EPowerUpType UWSpawnDistribution::SamplePowerUpType(float Height, int32 Difficulty, const FRandomStream& Stream) const
+{
+    const FCompiledBand* Band = FindBand(Height, Difficulty);
+    if (!Band || Band->PowerUpTable.IsEmpty())
+    {
+        return EPowerUpType::None;
+    }
+    return Band->PowerUpValues[Band->PowerUpTable.Sample(Stream)];
+}
+
+const UWSpawnDistribution::FCompiledBand* UWSpawnDistribution::FindBand(float Height, int32 Difficulty) const
+{
+    RebuildTablesIfNeeded();
+
+    if (CompiledBands.Num() == 0)
+    {
+        return nullptr;
+    }
+
+    const auto GetDifficulty = [](const FCompiledBand& Band) { return Band.Difficulty; };
+
+    // Без диапазонов запрошенной сложности берем ближайшую меньшую (или самую легкую,
+    // если все диапазоны сложнее) и ищем в ней по высоте
+    const int32 FirstHarder = Algo::UpperBoundBy(CompiledBands, Difficulty, GetDifficulty);
+    const int32 BandDifficulty = CompiledBands[FMath::Max(FirstHarder - 1, 0)].Difficulty;
+    if (BandDifficulty != Difficulty)
+    {
+        UE_LOG(LogTemp, Verbose, TEXT("WSpawnDistribution: No bands for difficulty %d in %s, using difficulty %d"),
+            Difficulty, *GetName(), BandDifficulty);
+    }
+
+    // Последний диапазон этой сложности, начинающийся не выше запрошенной высоты;
+    // ниже первого диапазона используем сам первый диапазон
+    const int32 First = Algo::LowerBoundBy(CompiledBands, BandDifficulty, GetDifficulty);
+    const int32 Index = Algo::UpperBoundBy(CompiledBands, TTuple<int32, float>(BandDifficulty, Height),
+        [](const FCompiledBand& Band) { return TTuple<int32, float>(Band.Difficulty, Band.MinHeight); }) - 1;
+
+    return &CompiledBands[FMath::Max(Index, First)];
+}
+
+void UWSpawnDistribution::RebuildTablesIfNeeded() const
+{
+    if (!bTablesDirty)
+    {
+        return;
+    }
+
+    CompiledBands.Reset(Bands.Num());
+    TArray<float> Weights;
+
+    for (const FWSpawnBand& Band : Bands)
+    {
+        FCompiledBand& Compiled = CompiledBands.AddDefaulted_GetRef();
+        Compiled.MinHeight = Band.MinHeight;
+        Compiled.Difficulty = Band.Difficulty;
+
+        Weights.Reset();
+        for (const TPair<EPlatformType, float>& Pair : Band.PlatformWeights)
+        {
+            Compiled.PlatformValues.Add(Pair.Key);
+            Weights.Add(Pair.Value);
+        }
+        Compiled.PlatformTable.Build(Weights);
+
+        Weights.Reset();
+        for (const TPair<EPowerUpType, float>& Pair : Band.PowerUpWeights)
+        {
+            Compiled.PowerUpValues.Add(Pair.Key);
+            Weights.Add(Pair.Value);
+        }
+        Compiled.PowerUpTable.Build(Weights);
+    }
+
+    Algo::SortBy(CompiledBands, [](const FCompiledBand& Band) { return TTuple<int32, float>(Band.Difficulty, Band.MinHeight); });
+    bTablesDirty = false;
+
+    UE_LOG(LogTemp, Log, TEXT("WSpawnDistribution: Rebuilt %d alias tables for %s"), CompiledBands.Num(), *GetName());
+}
+
+//----------------------------------------------------------------------------------------
+// НАСТРОЙКА ВЕСОВ
+//----------------------------------------------------------------------------------------
+
+void UWSpawnDistribution::RunSamplingReport(float Height, int32 Difficulty, int32 Seed, int32 NumSamples) const
+{
+    const FCompiledBand* Band = FindBand(Height, Difficulty);
+    if (!Band || NumSamples <= 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("WSpawnDistribution: No band for height %.1f, difficulty %d"), Height, Difficulty);
+        return;
+    }
+
+    FRandomStream Stream(Seed);
+    TArray<int32> PlatformCounts;
+    TArray<int32> PowerUpCounts;
+    PlatformCounts.SetNumZeroed(Band->PlatformTable.Num());
+    PowerUpCounts.SetNumZeroed(Band->PowerUpTable.Num());
+
+    // Плотный цикл без обращения к TMap: таблицы уже скомпилированы
+    const double StartTime = FPlatformTime::Seconds();
+    if (!Band->PlatformTable.IsEmpty())
+    {
+        for (int32 Sample = 0; Sample < NumSamples; ++Sample)
+        {
+            ++PlatformCounts[Band->PlatformTable.Sample(Stream)];
+        }
+    }
+    if (!Band->PowerUpTable.IsEmpty())
+    {
+        for (int32 Sample = 0; Sample < NumSamples; ++Sample)
+        {
+            ++PowerUpCounts[Band->PowerUpTable.Sample(Stream)];
+        }
+    }
+    const double Elapsed = FPlatformTime::Seconds() - StartTime;
+
+    UE_LOG(LogTemp, Log, TEXT("WSpawnDistribution: %d samples x2 in %.2f ms (%.1f M samples/s)"),
+        NumSamples, Elapsed * 1000.0, Elapsed > 0.0 ? (2.0 * NumSamples) / Elapsed / 1.0e6 : 0.0);
+
+    for (int32 Index = 0; Index < PlatformCounts.Num(); ++Index)
+    {
+        UE_LOG(LogTemp, Log, TEXT("  %s: %.4f"), *UEnum::GetValueAsString(Band->PlatformValues[Index]),
+            static_cast<double>(PlatformCounts[Index]) / NumSamples);
+    }
+    for (int32 Index = 0; Index < PowerUpCounts.Num(); ++Index)
+    {
+        UE_LOG(LogTemp, Log, TEXT("  %s: %.4f"), *UEnum::GetValueAsString(Band->PowerUpValues[Index]),
+            static_cast<double>(PowerUpCounts[Index]) / NumSamples);
+    }
+}
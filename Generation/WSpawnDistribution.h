@@ -0,0 +1,93 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "WAliasTable.h"
+#include "../DoodlePlatform.h"
+#include "../PowerUpComponent.h"
+#include "WSpawnDistribution.generated.h"
+
+/**
+ * Веса типов платформ и усилений для одного диапазона высот и сложности
+ */
+USTRUCT(BlueprintType)
+struct FWSpawnBand
+{
+    GENERATED_BODY()
+
+    // Нижняя граница диапазона высот (до границы следующего диапазона)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Распределение")
+    float MinHeight;
+
+    // Сложность, к которой относится диапазон
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Распределение")
+    int32 Difficulty;
+
+    // Веса типов платформ
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Распределение")
+    TMap<EPlatformType, float> PlatformWeights;
+
+    // Веса типов усилений (None - платформа без усиления)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Распределение")
+    TMap<EPowerUpType, float> PowerUpWeights;
+
+    FWSpawnBand()
+        : MinHeight(0.0f)
+        , Difficulty(0)
+    {
+    }
+};
+
+/**
+ * Сервис распределений для генерации: строит таблицы Уолкера из весов дизайнера
+ * по диапазонам высот и сложности и выдает типы платформ и усилений за O(1)
+ * из потока случайных чисел забега. Таблицы перестраиваются только при изменении весов.
+ */
+UCLASS(BlueprintType)
+class WTOWER_API UWSpawnDistribution : public UDataAsset
+{
+    GENERATED_BODY()
+
+public:
+    // Диапазоны весов
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Распределение")
+    TArray<FWSpawnBand> Bands;
+
+    // Выбрать тип платформы для высоты и сложности
+    EPlatformType SamplePlatformType(float Height, int32 Difficulty, const FRandomStream& Stream) const;
+
+    // Выбрать тип усиления для высоты и сложности (None - без усиления)
+    EPowerUpType SamplePowerUpType(float Height, int32 Difficulty, const FRandomStream& Stream) const;
+
+    // Заменить веса во время игры (таблицы будут перестроены при следующей выборке)
+    UFUNCTION(BlueprintCallable, Category = "Распределение")
+    void SetBands(const TArray<FWSpawnBand>& NewBands);
+
+    // Сделать NumSamples выборок для настройки весов и вывести гистограммы и скорость в лог
+    UFUNCTION(BlueprintCallable, Category = "Распределение")
+    void RunSamplingReport(float Height, int32 Difficulty, int32 Seed, int32 NumSamples = 1000000) const;
+
+    virtual void PostLoad() override;
+#if WITH_EDITOR
+    virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+private:
+    // Скомпилированный диапазон
+    struct FCompiledBand
+    {
+        float MinHeight;
+        int32 Difficulty;
+        FWAliasTable PlatformTable;
+        TArray<EPlatformType> PlatformValues;
+        FWAliasTable PowerUpTable;
+        TArray<EPowerUpType> PowerUpValues;
+    };
+
+    // Диапазоны, отсортированные по сложности и высоте
+    mutable TArray<FCompiledBand> CompiledBands;
+    mutable bool bTablesDirty = true;
+
+    void RebuildTablesIfNeeded() const;
+    const FCompiledBand* FindBand(float Height, int32 Difficulty) const;
+};
@@ -0,0 +1,98 @@
+#include "WLevelRegistry.h"
+#include "Misc/PackageName.h"
+
+UWLevelRegistry* UWLevelRegistry::CreateDefault(UObject* Outer)
+{
+    UWLevelRegistry* Registry = NewObject<UWLevelRegistry>(Outer);
+
+    // Прежняя жестко заданная последовательность уровней
+    const TCHAR* DefaultLevels[] = { TEXT("MainMenu"), TEXT("Level_1"), TEXT("Level_2"), TEXT("Level_3") };
+    for (int32 Index = 0; Index < UE_ARRAY_COUNT(DefaultLevels); ++Index)
+    {
+        FWLevelEntry& Entry = Registry->Levels.AddDefaulted_GetRef();
+        Entry.LevelId = Index;
+        Entry.LevelName = DefaultLevels[Index];
+        Entry.DisplayName = FText::FromName(Entry.LevelName);
+        Entry.bIsMenu = Index == 0;
+
+        // Без ассета карты переход не может загрузить ее заранее: ищем пакет по имени один раз при создании
+        FString LongPackageName;
+        if (FPackageName::SearchForPackageOnDisk(Entry.LevelName.ToString(), &LongPackageName))
+        {
+            Entry.Map = TSoftObjectPtr<UWorld>(FSoftObjectPath(LongPackageName + TEXT(".") + Entry.LevelName.ToString()));
+        }
+        else
+        {
+            UE_LOG(LogTemp, Warning, TEXT("WLevelRegistry: Map package for %s not found, it will not be preloaded"), *Entry.LevelName.ToString());
+        }
+    }
+
+    Registry->BuildLookup();
+    return Registry;
+}
+
+void UWLevelRegistry::BuildLookup()
+{
+    MaxLevelId = INDEX_NONE;
+    for (const FWLevelEntry& Entry : Levels)
+    {
+        MaxLevelId = FMath::Max(MaxLevelId, Entry.LevelId);
+    }
+
+    SequenceIndexById.Init(INDEX_NONE, MaxLevelId + 1);
+    IdByName.Reset();
+    TravelNames.Reset(Levels.Num());
+
+    for (int32 SequenceIndex = 0; SequenceIndex < Levels.Num(); ++SequenceIndex)
+    {
+        const FWLevelEntry& Entry = Levels[SequenceIndex];
+
+        // Имя пакета карты предпочтительнее короткого имени (по индексу в последовательности)
+        TravelNames.Add(Entry.Map.IsNull() ? Entry.LevelName : FName(*Entry.Map.GetLongPackageName()));
+
+        // Отрицательный идентификатор задан в ассете по ошибке: уровень остается в последовательности,
+        // но найти его по идентификатору нельзя
+        if (Entry.LevelId < 0)
+        {
+            UE_LOG(LogTemp, Error, TEXT("WLevelRegistry: Invalid level id %d (%s), skipped"), Entry.LevelId, *Entry.LevelName.ToString());
+            continue;
+        }
+
+        if (SequenceIndexById[Entry.LevelId] != INDEX_NONE)
+        {
+            UE_LOG(LogTemp, Error, TEXT("WLevelRegistry: Duplicate level id %d (%s)"), Entry.LevelId, *Entry.LevelName.ToString());
+        }
+
+        SequenceIndexById[Entry.LevelId] = SequenceIndex;
+        IdByName.Add(Entry.LevelName, Entry.LevelId);
+    }
+}
+
+int32 UWLevelRegistry::FindLevelId(FName LevelName) const
+{
+    const int32* LevelId = IdByName.Find(LevelName);
+    return LevelId ? *LevelId : INDEX_NONE;
+}
+
+const FWLevelEntry* UWLevelRegistry::FindEntry(int32 LevelId) const
+{
+    const int32 SequenceIndex = GetSequenceIndex(LevelId);
+    return SequenceIndex != INDEX_NONE ? &Levels[SequenceIndex] : nullptr;
+}
+
+int32 UWLevelRegistry::GetSequenceIndex(int32 LevelId) const
+{
+    return SequenceIndexById.IsValidIndex(LevelId) ? SequenceIndexById[LevelId] : INDEX_NONE;
+}
+
+int32 UWLevelRegistry::GetFirstPlayableLevelId() const
+{
+    for (const FWLevelEntry& Entry : Levels)
+    {
+        if (!Entry.bIsMenu)
+        {
+            return Entry.LevelId;
+        }
+    }
+    return INDEX_NONE;
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "WLevelRegistry.generated.h"
+
+class USoundBase;
+
+/**
+ * Музыкальный слой уровня, включаемый по высоте
+ */
+USTRUCT(BlueprintType)
+struct FWMusicLayer
+{
+    GENERATED_BODY()
+
+    // Максимальная высота забега, с которой включается слой
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Музыка", meta = (ClampMin = "0.0"))
+    float MinHeight;
+
+    // Трек слоя
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Музыка")
+    TSoftObjectPtr<USoundBase> Track;
+
+    FWMusicLayer()
+        : MinHeight(0.0f)
+    {
+    }
+};
+
+/**
+ * Описание уровня в реестре
+ */
+USTRUCT(BlueprintType)
+struct FWLevelEntry
+{
+    GENERATED_BODY()
+
+    // Стабильный компактный идентификатор уровня (не меняется и не используется повторно)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Уровень", meta = (ClampMin = "0"))
+    int32 LevelId;
+
+    // Имя карты, оно же ключ прогресса в старых сохранениях
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Уровень")
+    FName LevelName;
+
+    // Ассет карты (если не задан, карта открывается по LevelName)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Уровень")
+    TSoftObjectPtr<UWorld> Map;
+
+    // Отображаемое название
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Уровень")
+    FText DisplayName;
+
+    // Уровень является меню и не хранит прогресс
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Уровень")
+    bool bIsMenu;
+
+    // Ассеты, которые нужно подгрузить перед входом на уровень
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Уровень")
+    TArray<FSoftObjectPath> PreloadAssets;
+
+    // Музыка уровня (если не задана, продолжает играть предыдущая)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Музыка")
+    TSoftObjectPtr<USoundBase> Music;
+
+    // Слои музыки по высоте для бесконечного режима (заменяют Music, по возрастанию MinHeight)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Музыка")
+    TArray<FWMusicLayer> MusicLayers;
+
+    // Звуковые эффекты уровня: загружаются при входе и удерживаются аудиокэшем
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Музыка")
+    TArray<TSoftObjectPtr<USoundBase>> AudioCues;
+
+    FWLevelEntry()
+        : LevelId(0)
+        , bIsMenu(false)
+    {
+    }
+};
+
+/**
+ * Реестр уровней: порядок прохождения, стабильные идентификаторы,
+ * карты, метаданные и списки предзагрузки
+ */
+UCLASS(BlueprintType)
+class WTOWER_API UWLevelRegistry : public UPrimaryDataAsset
+{
+    GENERATED_BODY()
+
+public:
+    // Уровни в порядке прохождения
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Уровни")
+    TArray<FWLevelEntry> Levels;
+
+    // Создать реестр с последовательностью уровней по умолчанию
+    static UWLevelRegistry* CreateDefault(UObject* Outer);
+
+    // Построить таблицы поиска (вызывается один раз после загрузки)
+    void BuildLookup();
+
+    // Найти идентификатор по имени карты (INDEX_NONE, если уровня нет)
+    UFUNCTION(BlueprintCallable, Category = "Уровни")
+    int32 FindLevelId(FName LevelName) const;
+
+    // Найти уровень по идентификатору
+    const FWLevelEntry* FindEntry(int32 LevelId) const;
+
+    // Количество уровней в последовательности
+    UFUNCTION(BlueprintCallable, Category = "Уровни")
+    int32 GetNumLevels() const { return Levels.Num(); }
+
+    // Уровень по позиции в последовательности
+    const FWLevelEntry& GetEntryAt(int32 SequenceIndex) const { return Levels[SequenceIndex]; }
+
+    // Позиция уровня в последовательности
+    int32 GetSequenceIndex(int32 LevelId) const;
+
+    // Имя для OpenLevel (вычисляется один раз)
+    FName GetTravelName(int32 SequenceIndex) const { return TravelNames[SequenceIndex]; }
+
+    // Наибольший идентификатор (размер плотного массива прогресса - 1)
+    int32 GetMaxLevelId() const { return MaxLevelId; }
+
+    // Первый уровень, который не является меню
+    int32 GetFirstPlayableLevelId() const;
+
+private:
+    // Идентификатор -> позиция в последовательности
+    TArray<int32> SequenceIndexById;
+
+    // Имя карты -> идентификатор
+    TMap<FName, int32> IdByName;
+
+    // Имена карт для OpenLevel
+    TArray<FName> TravelNames;
+
+    int32 MaxLevelId = INDEX_NONE;
+};
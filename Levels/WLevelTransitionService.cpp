@@ -0,0 +1,315 @@
+#include "WLevelTransitionService.h"
+#include "WLevelRegistry.h"
+#include "../WTowerGameInstance.h"
+#include "Engine/AssetManager.h"
+#include "Engine/World.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameMapsSettings.h"
+#include "Kismet/GameplayStatics.h"
+#include "Sound/SoundBase.h"
+#include "UObject/UObjectGlobals.h"
+
+UWLevelTransitionService::UWLevelTransitionService()
+{
+    // Инициализация по умолчанию
+    bUseSeamlessTravel = true;
+    GameInstance = nullptr;
+    PreloadedWorld = nullptr;
+    PreloadSequenceIndex = INDEX_NONE;
+    PreloadStartTime = 0.0;
+    bPreloadInFlight = false;
+    TransitionStartTime = 0.0;
+    LastTransitionTimeMs = 0.0f;
+}
+
+void UWLevelTransitionService::Initialize(UWTowerGameInstance* InGameInstance)
+{
+    GameInstance = InGameInstance;
+    PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &UWLevelTransitionService::OnPostLoadMap);
+    SyncLoadHandle = FCoreUObjectDelegates::OnSyncLoadPackage.AddUObject(this, &UWLevelTransitionService::OnSyncLoadPackage);
+
+    UE_LOG(LogTemp, Log, TEXT("WLevelTransitionService: Initialized"));
+}
+
+void UWLevelTransitionService::Shutdown()
+{
+    FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+    FCoreUObjectDelegates::OnSyncLoadPackage.Remove(SyncLoadHandle);
+    FTSTicker::GetCoreTicker().RemoveTicker(SyncLoadReportHandle);
+    ResetPreload();
+
+    if (HUDBundleHandle.IsValid())
+    {
+        HUDBundleHandle->ReleaseHandle();
+        HUDBundleHandle.Reset();
+    }
+}
+
+//----------------------------------------------------------------------------------------
+// ПРЕДЗАГРУЗКА
+//----------------------------------------------------------------------------------------
+
+void UWLevelTransitionService::PreloadLevel(int32 SequenceIndex)
+{
+    UWLevelRegistry* Registry = GameInstance ? GameInstance->GetLevelRegistry() : nullptr;
+    if (!Registry || SequenceIndex < 0 || SequenceIndex >= Registry->GetNumLevels())
+        return;
+
+    if (SequenceIndex == PreloadSequenceIndex)
+        return;
+
+    ResetPreload();
+
+    const FWLevelEntry& Entry = Registry->GetEntryAt(SequenceIndex);
+    PreloadSequenceIndex = SequenceIndex;
+    PreloadStartTime = FPlatformTime::Seconds();
+
+    // Карта загружается только если задан ее ассет, иначе имя пакета неизвестно
+    if (!Entry.Map.IsNull())
+    {
+        PreloadPackageName = Entry.Map.GetLongPackageName();
+        bPreloadInFlight = true;
+        LoadPackageAsync(PreloadPackageName,
+            FLoadPackageAsyncDelegate::CreateUObject(this, &UWLevelTransitionService::OnPackagePreloaded));
+    }
+    else if (!Entry.bIsMenu)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("WLevelTransitionService: %s has no map asset, the map will load synchronously on travel"),
+            *Entry.LevelName.ToString());
+    }
+
+    // Ассеты и звуки уровня грузятся параллельно с картой
+    TArray<FSoftObjectPath> Assets = Entry.PreloadAssets;
+    for (const TSoftObjectPtr<USoundBase>& Cue : Entry.AudioCues)
+    {
+        if (!Cue.IsNull())
+        {
+            Assets.AddUnique(Cue.ToSoftObjectPath());
+        }
+    }
+
+    if (Assets.Num() > 0)
+    {
+        PreloadAssetsHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(Assets);
+    }
+
+    // HUD нужен на любом игровом уровне; из меню он загружается заранее
+    if (!Entry.bIsMenu)
+    {
+        PreloadHUDBundle();
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("WLevelTransitionService: Preloading %s (%d assets)"),
+        *Entry.LevelName.ToString(), Assets.Num());
+}
+
+void UWLevelTransitionService::PreloadHUDBundle()
+{
+    if (HUDBundleHandle.IsValid() || !GameInstance)
+        return;
+
+    const TArray<FSoftObjectPath> Paths = GameInstance->HUDBundle.GetAssetPaths();
+    if (Paths.Num() > 0)
+    {
+        HUDBundleHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(Paths);
+        UE_LOG(LogTemp, Log, TEXT("WLevelTransitionService: Preloading HUD bundle (%d assets)"), Paths.Num());
+    }
+}
+
+void UWLevelTransitionService::OnPackagePreloaded(const FName& PackageName, UPackage* LoadedPackage, EAsyncLoadingResult::Type Result)
+{
+    // Результат устаревшей предзагрузки игнорируем
+    if (!bPreloadInFlight || PackageName.ToString() != PreloadPackageName)
+        return;
+
+    bPreloadInFlight = false;
+
+    if (Result != EAsyncLoadingResult::Succeeded || !LoadedPackage)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("WLevelTransitionService: Failed to preload %s"), *PreloadPackageName);
+        return;
+    }
+
+    PreloadedWorld = UWorld::FindWorldInPackage(LoadedPackage);
+
+    const float LoadTimeMs = static_cast<float>((FPlatformTime::Seconds() - PreloadStartTime) * 1000.0);
+    UE_LOG(LogTemp, Log, TEXT("WLevelTransitionService: Preloaded %s in %.1f ms"), *PreloadPackageName, LoadTimeMs);
+
+    OnLevelPreloaded.Broadcast(PreloadSequenceIndex, LoadTimeMs);
+}
+
+float UWLevelTransitionService::GetPreloadProgress() const
+{
+    float Progress = 1.0f;
+    int32 NumParts = 0;
+    float Sum = 0.0f;
+
+    if (bPreloadInFlight)
+    {
+        // GetAsyncLoadPercentage возвращает проценты или -1, если пакет не в очереди
+        const float Percentage = GetAsyncLoadPercentage(FName(*PreloadPackageName));
+        Sum += Percentage >= 0.0f ? Percentage / 100.0f : 0.0f;
+        ++NumParts;
+    }
+
+    if (PreloadAssetsHandle.IsValid() && PreloadAssetsHandle->IsLoadingInProgress())
+    {
+        Sum += PreloadAssetsHandle->GetProgress();
+        ++NumParts;
+    }
+
+    if (NumParts > 0)
+    {
+        Progress = Sum / NumParts;
+    }
+    return Progress;
+}
+
+void UWLevelTransitionService::ResetPreload()
+{
+    if (PreloadAssetsHandle.IsValid())
+    {
+        PreloadAssetsHandle->ReleaseHandle();
+        PreloadAssetsHandle.Reset();
+    }
+
+    PreloadedWorld = nullptr;
+    PreloadSequenceIndex = INDEX_NONE;
+    PreloadPackageName.Reset();
+    bPreloadInFlight = false;
+}
+
+//----------------------------------------------------------------------------------------
+// ПЕРЕХОД
+//----------------------------------------------------------------------------------------
+
+void UWLevelTransitionService::MarkVictory()
+{
+    TransitionStartTime = FPlatformTime::Seconds();
+}
+
+void UWLevelTransitionService::TravelToLevel(int32 SequenceIndex)
+{
+    UWLevelRegistry* Registry = GameInstance ? GameInstance->GetLevelRegistry() : nullptr;
+    UWorld* World = GameInstance ? GameInstance->GetWorld() : nullptr;
+    if (!Registry || !World)
+        return;
+
+    // Если победа не отмечена, отсчет идет от запроса перехода
+    if (TransitionStartTime <= 0.0)
+    {
+        TransitionStartTime = FPlatformTime::Seconds();
+    }
+
+    const FName TravelName = Registry->GetTravelName(SequenceIndex);
+    const bool bWasPreloaded = SequenceIndex == PreloadSequenceIndex && PreloadedWorld != nullptr;
+
+    UE_LOG(LogTemp, Log, TEXT("WLevelTransitionService: Travel to %s (preloaded: %s)"),
+        *TravelName.ToString(), bWasPreloaded ? TEXT("yes") : TEXT("no"));
+
+    if (CanUseSeamlessTravel(World))
+    {
+        // Текущий мир остается живым до окончания загрузки, переход идет через переходную карту
+        World->ServerTravel(TravelName.ToString(), true);
+    }
+    else
+    {
+        UGameplayStatics::OpenLevel(World, TravelName);
+    }
+}
+
+bool UWLevelTransitionService::CanUseSeamlessTravel(UWorld* World) const
+{
+    if (!bUseSeamlessTravel)
+        return false;
+
+    const AGameModeBase* GameMode = World->GetAuthGameMode();
+    const bool bHasTransitionMap = !GetDefault<UGameMapsSettings>()->TransitionMap.IsNull();
+    return GameMode && GameMode->bUseSeamlessTravel && bHasTransitionMap;
+}
+
+void UWLevelTransitionService::OnPostLoadMap(UWorld* LoadedWorld)
+{
+    if (!LoadedWorld)
+        return;
+
+    // Уровень готов к игре после BeginPlay мира
+    if (LoadedWorld->HasBegunPlay())
+    {
+        OnWorldPlayable(LoadedWorld);
+    }
+    else
+    {
+        TWeakObjectPtr<UWorld> WeakWorld(LoadedWorld);
+        LoadedWorld->OnWorldBeginPlay.AddWeakLambda(this, [this, WeakWorld]()
+            {
+                if (UWorld* World = WeakWorld.Get())
+                {
+                    OnWorldPlayable(World);
+                }
+            });
+    }
+}
+
+void UWLevelTransitionService::OnWorldPlayable(UWorld* World)
+{
+    if (TransitionStartTime > 0.0)
+    {
+        LastTransitionTimeMs = static_cast<float>((FPlatformTime::Seconds() - TransitionStartTime) * 1000.0);
+        TransitionStartTime = 0.0;
+
+        UE_LOG(LogTemp, Log, TEXT("WLevelTransitionService: %s playable %.1f ms after victory"),
+            *World->GetMapName(), LastTransitionTimeMs);
+    }
+
+    // Предыдущая предзагрузка больше не нужна, начинаем следующую
+    ResetPreload();
+    if (GameInstance)
+    {
+        PreloadLevel(GameInstance->GetCurrentLevelIndex() + 1);
+    }
+}
+
+//----------------------------------------------------------------------------------------
+// СИНХРОННЫЕ ЗАГРУЗКИ
+//----------------------------------------------------------------------------------------
+
+bool UWLevelTransitionService::IsInGameplay() const
+{
+    const UWorld* World = GameInstance ? GameInstance->GetWorld() : nullptr;
+    if (!World || !World->HasBegunPlay() || TransitionStartTime > 0.0)
+        return false;
+
+    const UWLevelRegistry* Registry = GameInstance->GetLevelRegistry();
+    const FWLevelEntry* Entry = Registry ? Registry->FindEntry(GameInstance->GetCurrentLevelId()) : nullptr;
+    return Entry && !Entry->bIsMenu;
+}
+
+void UWLevelTransitionService::OnSyncLoadPackage(const FString& PackageName)
+{
+    if (!IsInGameplay())
+        return;
+
+    // Делегат вызывается в начале загрузки; длительность считается до следующего тика,
+    // то есть это верхняя оценка времени, на которое загрузка остановила кадр
+    PendingSyncLoads.Add({ PackageName, FPlatformTime::Seconds() });
+    if (!SyncLoadReportHandle.IsValid())
+    {
+        SyncLoadReportHandle = FTSTicker::GetCoreTicker().AddTicker(
+            FTickerDelegate::CreateUObject(this, &UWLevelTransitionService::ReportSyncLoads));
+    }
+}
+
+bool UWLevelTransitionService::ReportSyncLoads(float DeltaTime)
+{
+    const double Now = FPlatformTime::Seconds();
+    for (const FSyncLoad& Load : PendingSyncLoads)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("WLevelTransitionService: Synchronous load of %s during gameplay (up to %.1f ms)"),
+            *Load.PackageName, (Now - Load.StartTime) * 1000.0);
+    }
+
+    PendingSyncLoads.Reset();
+    SyncLoadReportHandle.Reset();
+    return false;
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "Engine/StreamableManager.h"
+#include "Containers/Ticker.h"
+#include "WLevelTransitionService.generated.h"
+
+class UWTowerGameInstance;
+
+// Предзагрузка уровня завершена (позиция в последовательности, время загрузки в мс)
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnWLevelPreloaded, int32, SequenceIndex, float, LoadTimeMs);
+
+/**
+ * Сервис переходов между уровнями.
+ * Пока идет текущий уровень, в фоне загружается следующий по последовательности
+ * вместе с его списком предзагрузки. Переход выполняется через переходную карту
+ * бесшовным путешествием, время от победы до готовности следующего уровня логируется.
+ * Ассеты HUD загружаются вместе с первым игровым уровнем и остаются в памяти.
+ * Синхронные загрузки во время игры логируются предупреждением с длительностью.
+ */
+UCLASS()
+class WTOWER_API UWLevelTransitionService : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    UWLevelTransitionService();
+
+    // Инициализация сервиса
+    void Initialize(UWTowerGameInstance* InGameInstance);
+
+    // Завершение работы
+    void Shutdown();
+
+    // Начать фоновую загрузку уровня по позиции в последовательности
+    UFUNCTION(BlueprintCallable, Category = "Уровни|Переход")
+    void PreloadLevel(int32 SequenceIndex);
+
+    // Перейти на уровень по позиции в последовательности
+    UFUNCTION(BlueprintCallable, Category = "Уровни|Переход")
+    void TravelToLevel(int32 SequenceIndex);
+
+    // Отметить момент победы (начало отсчета времени перехода)
+    UFUNCTION(BlueprintCallable, Category = "Уровни|Переход")
+    void MarkVictory();
+
+    // Прогресс фоновой загрузки от 0 до 1 (1, если загрузка не идет)
+    UFUNCTION(BlueprintCallable, Category = "Уровни|Переход")
+    float GetPreloadProgress() const;
+
+    // Время последнего перехода от победы (или запроса) до готовности уровня
+    UFUNCTION(BlueprintCallable, Category = "Уровни|Переход")
+    float GetLastTransitionTimeMs() const { return LastTransitionTimeMs; }
+
+    // Использовать бесшовное путешествие через переходную карту, если оно настроено
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Уровни|Переход")
+    bool bUseSeamlessTravel;
+
+    // Вызывается после окончания фоновой загрузки уровня
+    UPROPERTY(BlueprintAssignable, Category = "Уровни|Переход")
+    FOnWLevelPreloaded OnLevelPreloaded;
+
+private:
+    UPROPERTY()
+    UWTowerGameInstance* GameInstance;
+
+    // Загруженная в фоне карта (держим ссылку, чтобы ее не собрал GC)
+    UPROPERTY()
+    UObject* PreloadedWorld;
+
+    // Позиция предзагружаемого уровня и его пакет
+    int32 PreloadSequenceIndex;
+    FString PreloadPackageName;
+    double PreloadStartTime;
+    bool bPreloadInFlight;
+
+    // Ассеты из списка предзагрузки реестра
+    TSharedPtr<FStreamableHandle> PreloadAssetsHandle;
+
+    // Ассеты HUD (загружаются один раз на сессию)
+    TSharedPtr<FStreamableHandle> HUDBundleHandle;
+
+    // Синхронные загрузки во время игры, ожидающие отчета в следующем кадре
+    struct FSyncLoad
+    {
+        FString PackageName;
+        double StartTime;
+    };
+    TArray<FSyncLoad> PendingSyncLoads;
+    FTSTicker::FDelegateHandle SyncLoadReportHandle;
+    FDelegateHandle SyncLoadHandle;
+
+    // Отсчет времени перехода
+    double TransitionStartTime;
+    float LastTransitionTimeMs;
+
+    FDelegateHandle PostLoadMapHandle;
+
+    void OnPackagePreloaded(const FName& PackageName, UPackage* LoadedPackage, EAsyncLoadingResult::Type Result);
+    void OnPostLoadMap(UWorld* LoadedWorld);
+    void OnWorldPlayable(UWorld* World);
+    void ResetPreload();
+
+    // Загрузить ассеты HUD, если они еще не загружаются
+    void PreloadHUDBundle();
+
+    void OnSyncLoadPackage(const FString& PackageName);
+    bool ReportSyncLoads(float DeltaTime);
+
+    // Идет ли игра на уровне (не меню и не переход)
+    bool IsInGameplay() const;
+
+    // Настроено ли бесшовное путешествие в текущем мире
+    bool CanUseSeamlessTravel(UWorld* World) const;
+};
@@ -0,0 +1,120 @@
+#include "WTowerCharacterMovementComponent.h"
+#include "../WTowerStats.h"
+
+UWTowerCharacterMovementComponent::UWTowerCharacterMovementComponent()
+{
+    bWantsInitializeComponent = true;
+
+    // Значения по умолчанию совпадают с прежним таймером в APlayerCharacter
+    bAutoBounce = true;
+    AutoBounceVelocity = 850.0f;
+    GroundContactTime = 0.1f;
+    InitialGroundContactTime = 0.5f;
+    bClearHorizontalVelocityOnBounce = true;
+
+    ContactTime = 0.0f;
+    bFirstContact = true;
+    bBounceRequested = false;
+    BounceTriggerRealTime = 0.0;
+    BaseJumpZVelocity = 0.0f;
+    LastBounceLatencyRealMs = 0.0f;
+    LastBounceLatencySimMs = 0.0f;
+}
+
+void UWTowerCharacterMovementComponent::InitializeComponent()
+{
+    Super::InitializeComponent();
+
+    BaseJumpZVelocity = JumpZVelocity;
+    BounceTriggerRealTime = FPlatformTime::Seconds();
+}
+
+void UWTowerCharacterMovementComponent::RequestBounce()
+{
+    if (!bBounceRequested)
+    {
+        bBounceRequested = true;
+        BounceTriggerRealTime = FPlatformTime::Seconds();
+    }
+}
+
+void UWTowerCharacterMovementComponent::ResetBounceState()
+{
+    ContactTime = 0.0f;
+    bFirstContact = true;
+    bBounceRequested = false;
+    BounceTriggerRealTime = FPlatformTime::Seconds();
+}
+
+void UWTowerCharacterMovementComponent::OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode)
+{
+    Super::OnMovementModeChanged(PreviousMovementMode, PreviousCustomMode);
+
+    // Приземление: начинаем отсчет контакта с землей
+    if (IsMovingOnGround() && PreviousMovementMode != MOVE_Walking && PreviousMovementMode != MOVE_NavWalking)
+    {
+        ContactTime = 0.0f;
+        if (!bBounceRequested)
+        {
+            BounceTriggerRealTime = FPlatformTime::Seconds();
+        }
+    }
+}
+
+void UWTowerCharacterMovementComponent::PhysWalking(float deltaTime, int32 Iterations)
+{
+    const float RequiredContact = bBounceRequested ? 0.0f : (bFirstContact ? InitialGroundContactTime : GroundContactTime);
+    const bool bShouldBounce = (bAutoBounce || bBounceRequested) && ContactTime + deltaTime >= RequiredContact;
+
+    if (!bShouldBounce)
+    {
+        ContactTime += deltaTime;
+        Super::PhysWalking(deltaTime, Iterations);
+        return;
+    }
+
+    // Дошагиваем по земле ровно до момента отскока, остаток шага уже в полете
+    const float TimeOnGround = FMath::Clamp(RequiredContact - ContactTime, 0.0f, deltaTime);
+    if (TimeOnGround > 0.0f)
+    {
+        ContactTime += TimeOnGround;
+        Super::PhysWalking(TimeOnGround, Iterations);
+    }
+
+    if (IsMovingOnGround())
+    {
+        Bounce(deltaTime - TimeOnGround, Iterations);
+    }
+}
+
+void UWTowerCharacterMovementComponent::Bounce(float RemainingTime, int32 Iterations)
+{
+    // Усиления и пружинные платформы меняют JumpZVelocity, сохраняем их множитель
+    const float JumpScale = BaseJumpZVelocity > 0.0f ? JumpZVelocity / BaseJumpZVelocity : 1.0f;
+
+    if (bClearHorizontalVelocityOnBounce)
+    {
+        Velocity.X = 0.0f;
+        Velocity.Y = 0.0f;
+    }
+    Velocity.Z = AutoBounceVelocity * JumpScale;
+    SetMovementMode(MOVE_Falling);
+
+    // Задержка от приземления до отрыва
+    LastBounceLatencySimMs = ContactTime * 1000.0f;
+    LastBounceLatencyRealMs = static_cast<float>((FPlatformTime::Seconds() - BounceTriggerRealTime) * 1000.0);
+    SET_FLOAT_STAT(STAT_TowerBounceLatencySim, LastBounceLatencySimMs);
+    SET_FLOAT_STAT(STAT_TowerBounceLatencyReal, LastBounceLatencyRealMs);
+
+    ContactTime = 0.0f;
+    bFirstContact = false;
+    bBounceRequested = false;
+
+    OnAutoBounce.Broadcast();
+
+    // Остаток шага симулируем уже в полете
+    if (RemainingTime > KINDA_SMALL_NUMBER)
+    {
+        StartNewPhysics(RemainingTime, Iterations);
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "WTowerCharacterMovementComponent.generated.h"
+
+DECLARE_MULTICAST_DELEGATE(FOnWAutoBounce);
+
+/**
+ * Компонент движения с автоматическим отскоком внутри шага физики.
+ * Время контакта с землей считается во времени симуляции, поэтому отскок
+ * не зависит от частоты кадров и происходит в том же подшаге, где истекло время.
+ */
+UCLASS()
+class WTOWER_API UWTowerCharacterMovementComponent : public UCharacterMovementComponent
+{
+    GENERATED_BODY()
+
+public:
+    UWTowerCharacterMovementComponent();
+
+    // Включить автоматический отскок от земли
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Автопрыжок")
+    bool bAutoBounce;
+
+    // Вертикальная скорость отскока (масштабируется вместе с JumpZVelocity усилений)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Автопрыжок")
+    float AutoBounceVelocity;
+
+    // Время контакта с землей перед отскоком (время симуляции)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Автопрыжок", meta = (ClampMin = "0.0"))
+    float GroundContactTime;
+
+    // Время контакта перед самым первым отскоком после появления
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Автопрыжок", meta = (ClampMin = "0.0"))
+    float InitialGroundContactTime;
+
+    // Обнулять горизонтальную скорость при отскоке для стабильной траектории
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Автопрыжок")
+    bool bClearHorizontalVelocityOnBounce;
+
+    // Отскочить на ближайшем шаге физики, не дожидаясь окончания контакта
+    UFUNCTION(BlueprintCallable, Category = "Автопрыжок")
+    void RequestBounce();
+
+    // Вернуть автопрыжок в состояние сразу после появления (для мягкого перезапуска забега)
+    void ResetBounceState();
+
+    // Задержка последнего отскока от приземления или запроса (мс)
+    UFUNCTION(BlueprintCallable, Category = "Автопрыжок")
+    float GetLastBounceLatencyRealMs() const { return LastBounceLatencyRealMs; }
+
+    UFUNCTION(BlueprintCallable, Category = "Автопрыжок")
+    float GetLastBounceLatencySimMs() const { return LastBounceLatencySimMs; }
+
+    // Вызывается в момент отрыва от земли
+    FOnWAutoBounce OnAutoBounce;
+
+protected:
+    virtual void InitializeComponent() override;
+    virtual void PhysWalking(float deltaTime, int32 Iterations) override;
+    virtual void OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode) override;
+
+private:
+    // Время на земле с момента приземления
+    float ContactTime;
+
+    // Первый контакт после появления
+    bool bFirstContact;
+
+    // Запрошен немедленный отскок
+    bool bBounceRequested;
+
+    // Момент приземления или запроса в реальном времени
+    double BounceTriggerRealTime;
+
+    // Базовая скорость прыжка для учета усилений, меняющих JumpZVelocity
+    float BaseJumpZVelocity;
+
+    float LastBounceLatencyRealMs;
+    float LastBounceLatencySimMs;
+
+    void Bounce(float RemainingTime, int32 Iterations);
+};
@@ -6,14 +6,30 @@
 #include "GameFramework/SpringArmComponent.h"
 #include "WTowerGameState.h"
 #include "WTowerHUD.h"
+#include "Movement/WTowerCharacterMovementComponent.h"
+#include "Gameplay/WTowerRunSubsystem.h"
+#include "WTowerGameInstance.h"
+#include "Audio/WAudioManager.h"
+#include "WTowerStats.h"
 #include "Particles/ParticleSystemComponent.h"
 #include "Kismet/GameplayStatics.h"
 
+namespace
+{
+    // GameState берется из кэша подсистемы забега, без поиска и приведения на каждый вызов
+    AWTowerGameState* GetTowerGameState(const AActor* Actor)
+    {
+        UWTowerRunSubsystem* Run = UWTowerRunSubsystem::Get(Actor);
+        return Run ? Run->GetTowerGameState() : nullptr;
+    }
+}
+
 //----------------------------------------------------------------------------------------
 // КОНСТРУКТОР И ИНИЦИАЛИЗАЦИЯ
 //----------------------------------------------------------------------------------------
 
-APlayerCharacter::APlayerCharacter()
+APlayerCharacter::APlayerCharacter(const FObjectInitializer& ObjectInitializer)
+    : Super(ObjectInitializer.SetDefaultSubobjectClass<UWTowerCharacterMovementComponent>(ACharacter::CharacterMovementComponentName))
 {
     // Включаем Tick
     PrimaryActorTick.bCanEverTick = true;
@@ -65,6 +81,14 @@ APlayerCharacter::APlayerCharacter()
 
     // Значения по умолчанию
     JumpPower = 850.0f;
+
+    // Автопрыжок выполняется компонентом движения внутри шага физики
+    if (UWTowerCharacterMovementComponent* TowerMovement = Cast<UWTowerCharacterMovementComponent>(MovementComponent))
+    {
+        TowerMovement->AutoBounceVelocity = JumpPower;
+        TowerMovement->GroundContactTime = 0.1f;
+        TowerMovement->InitialGroundContactTime = 0.5f;
+    }
     CameraSensitivity = 2.0f;
     MinPitchAngle = -80.0f;
     MaxPitchAngle = 80.0f;
@@ -92,14 +116,16 @@ void APlayerCharacter::BeginPlay()
 {
     Super::BeginPlay();
 
-    // Инициализируем первый прыжок с задержкой
-    GetWorldTimerManager().SetTimer(
-        JumpTimerHandle,
-        this,
-        &APlayerCharacter::PerformJump,
-        0.5f,
-        false
-    );
+    // Первый и все последующие отскоки выполняет компонент движения,
+    // здесь только синхронизируем силу прыжка и подписываемся на звук
+    if (UWTowerCharacterMovementComponent* TowerMovement = Cast<UWTowerCharacterMovementComponent>(GetCharacterMovement()))
+    {
+        TowerMovement->AutoBounceVelocity = JumpPower;
+        TowerMovement->OnAutoBounce.AddWeakLambda(this, [this]()
+            {
+                PlayCharacterSound(JumpSound);
+            });
+    }
 
     // Инициализируем поворот камеры
     if (Controller)
@@ -124,6 +150,7 @@ void APlayerCharacter::BeginPlay()
 // Добавьте вызов UpdateHeight в метод Tick персонажа:
 void APlayerCharacter::Tick(float DeltaTime)
 {
+    WTOWER_SCOPE_TICK(STAT_TowerPlayerTick, Player);
     Super::Tick(DeltaTime);
 
     // Поворачиваем персонажа в соответствии с камерой
@@ -133,7 +160,7 @@ void APlayerCharacter::Tick(float DeltaTime)
         SetActorRotation(FRotator(0.0f, ControlRotation.Yaw, 0.0f));
     }
 
-    // Обновляем высоту персонажа в GameState каждый кадр
+    // Сообщаем высоту трекеру, в GameState она попадет только при заметном изменении
     UpdateHeight();
   
 }
@@ -321,18 +348,8 @@ void APlayerCharacter::Landed(const FHitResult& Hit)
     // Воспроизводим звук приземления
     PlayCharacterSound(LandSound);
 
-    // Планируем следующий прыжок с небольшой задержкой
-    // Задержка в 0.1 секунды необходима для того, чтобы:
-    // 1. Дать персонажу стабилизироваться после приземления
-    // 2. Избежать "залипания" в земле из-за слишком раннего прыжка
-    // 3. Создать естественную паузу между прыжками
-    GetWorldTimerManager().SetTimer(
-        JumpTimerHandle,
-        this,
-        &APlayerCharacter::PerformJump,
-        0.1f,
-        false
-    );
+    // Следующий прыжок выполнит UWTowerCharacterMovementComponent после
+    // GroundContactTime на земле (время симуляции), поэтому таймер здесь не нужен
 }
 
 void APlayerCharacter::PerformJump()
@@ -340,22 +357,12 @@ void APlayerCharacter::PerformJump()
     // Проверяем, находимся ли мы на земле
     if (GetCharacterMovement()->IsMovingOnGround())
     {
-        // Очищаем горизонтальную скорость перед прыжком
-        // для более контролируемой траектории
-        FVector Velocity = GetCharacterMovement()->Velocity;
-        Velocity.X = 0.0f;
-        Velocity.Y = 0.0f;
-        GetCharacterMovement()->Velocity = Velocity;
-
-        // Воспроизводим звук прыжка
-        PlayCharacterSound(JumpSound);
-
-        // Вызываем базовую функцию Jump
-        Jump();
-
-        // Устанавливаем только вертикальную скорость для
-        // стабильной траектории прыжка
-        GetCharacterMovement()->Velocity = FVector(0.0f, 0.0f, JumpPower);
+        // Отскок выполняется на ближайшем шаге физики компонента движения
+        // (он же обнуляет горизонтальную скорость и проигрывает звук через OnAutoBounce)
+        if (UWTowerCharacterMovementComponent* TowerMovement = Cast<UWTowerCharacterMovementComponent>(GetCharacterMovement()))
+        {
+            TowerMovement->RequestBounce();
+        }
     }
 }
 
@@ -365,13 +372,18 @@ void APlayerCharacter::PerformJump()
 
 void APlayerCharacter::PlayCharacterSound(USoundBase* Sound)
 {
-    if (Sound)
+    if (!Sound)
+        return;
+
+    // Прыжки и приземления идут через пул голосов аудио менеджера с лимитом категории
+    UWTowerGameInstance* GameInstance = GetGameInstance<UWTowerGameInstance>();
+    if (UWAudioManager* AudioManager = GameInstance ? GameInstance->GetAudioManager() : nullptr)
     {
-        UGameplayStatics::PlaySoundAtLocation(
-            this,
-            Sound,
-            GetActorLocation()
-        );
+        AudioManager->PlaySoundEffect(Sound, GetActorLocation(), EWSoundCategory::Player);
+    }
+    else
+    {
+        UGameplayStatics::PlaySoundAtLocation(this, Sound, GetActorLocation());
     }
 }
 
@@ -382,7 +394,7 @@ void APlayerCharacter::PlayCharacterSound(USoundBase* Sound)
 void APlayerCharacter::AddScore(int32 Points)
 {
     // Получаем GameState и используем его методы
-    if (AWTowerGameState* GameState = Cast<AWTowerGameState>(GetWorld()->GetGameState()))
+    if (AWTowerGameState* GameState = GetTowerGameState(this))
     {
         GameState->AddScore(Points);
     }
@@ -391,7 +403,7 @@ void APlayerCharacter::AddScore(int32 Points)
 int32 APlayerCharacter::GetScore() const
 {
     // Получаем счет из GameState
-    if (AWTowerGameState* GameState = Cast<AWTowerGameState>(GetWorld()->GetGameState()))
+    if (AWTowerGameState* GameState = GetTowerGameState(this))
     {
         return GameState->GetScore();
     }
@@ -401,7 +413,7 @@ int32 APlayerCharacter::GetScore() const
 float APlayerCharacter::GetGameTime() const
 {
     // Получаем время игры из GameState
-    if (AWTowerGameState* GameState = Cast<AWTowerGameState>(GetWorld()->GetGameState()))
+    if (AWTowerGameState* GameState = GetTowerGameState(this))
     {
         return GameState->GetGameTime();
     }
@@ -411,7 +423,7 @@ float APlayerCharacter::GetGameTime() const
 float APlayerCharacter::GetMaxHeight() const
 {
     // Получаем максимальную высоту из GameState
-    if (AWTowerGameState* GameState = Cast<AWTowerGameState>(GetWorld()->GetGameState()))
+    if (AWTowerGameState* GameState = GetTowerGameState(this))
     {
         return GameState->GetPlayerMaxHeight();
     }
@@ -421,7 +433,7 @@ float APlayerCharacter::GetMaxHeight() const
 void APlayerCharacter::CompleteGame()
 {
     // Устанавливаем флаг завершения игры в GameState
-    if (AWTowerGameState* GameState = Cast<AWTowerGameState>(GetWorld()->GetGameState()))
+    if (AWTowerGameState* GameState = GetTowerGameState(this))
     {
         GameState->SetGameCompleted();
     }
@@ -429,10 +441,12 @@ void APlayerCharacter::CompleteGame()
 
 void APlayerCharacter::UpdateHeight()
 {
-    // Обновляем текущую высоту персонажа в GameState
-    if (AWTowerGameState* GameState = Cast<AWTowerGameState>(GetWorld()->GetGameState()))
+    WTOWER_SCOPE_CYCLE(STAT_TowerPlayerUpdateHeight);
+
+    // Трекер публикует высоту только при смещении на шаг квантования или новом максимуме
+    if (UWTowerRunSubsystem* Run = UWTowerRunSubsystem::Get(this))
     {
-        GameState->UpdatePlayerHeight(GetActorLocation().Z);
+        Run->ReportPlayerHeight(GetActorLocation().Z);
     }
 }
 
@@ -488,4 +502,63 @@ void APlayerCharacter::DisplayActivePowerUp(EPowerUpType PowerUpType, float Dura
             false
         );
     }
-}
\ No newline at end of file
+}
+
+//----------------------------------------------------------------------------------------
+// МЯГКИЙ ПЕРЕЗАПУСК
+//----------------------------------------------------------------------------------------
+
+void APlayerCharacter::ResetRunState(const FTransform& StartTransform)
+{
+    // Снимаем таймеры усилений и индикаторы на HUD
+    AWTowerHUD* HUD = nullptr;
+    if (APlayerController* PC = Cast<APlayerController>(GetController()))
+    {
+        HUD = Cast<AWTowerHUD>(PC->GetHUD());
+    }
+
+    for (TPair<EPowerUpType, bool>& PowerUp : ActivePowerUps)
+    {
+        if (PowerUp.Value)
+        {
+            PowerUp.Value = false;
+            if (HUD)
+            {
+                HUD->HidePowerUp(PowerUp.Key);
+            }
+            NotifyPowerUpDeactivated(PowerUp.Key);
+        }
+    }
+
+    for (TPair<EPowerUpType, FTimerHandle>& Timer : ActivePowerUpTimers)
+    {
+        GetWorldTimerManager().ClearTimer(Timer.Value);
+    }
+    GetWorldTimerManager().ClearAllTimersForObject(this);
+
+    // Эффекты усилений меняют параметры движения, возвращаем значения по умолчанию класса
+    UCharacterMovementComponent* Movement = GetCharacterMovement();
+    const APlayerCharacter* Defaults = GetClass()->GetDefaultObject<APlayerCharacter>();
+    if (const UCharacterMovementComponent* DefaultMovement = Defaults->GetCharacterMovement())
+    {
+        Movement->GravityScale = DefaultMovement->GravityScale;
+        Movement->JumpZVelocity = DefaultMovement->JumpZVelocity;
+        Movement->MaxWalkSpeed = DefaultMovement->MaxWalkSpeed;
+        Movement->AirControl = DefaultMovement->AirControl;
+    }
+
+    // Переносим персонажа на старт без проверки коллизий и останавливаем движение
+    Movement->StopMovementImmediately();
+    TeleportTo(StartTransform.GetLocation(), StartTransform.Rotator(), false, true);
+    Movement->SetMovementMode(MOVE_Falling);
+
+    if (UWTowerCharacterMovementComponent* TowerMovement = Cast<UWTowerCharacterMovementComponent>(Movement))
+    {
+        TowerMovement->ResetBounceState();
+    }
+
+    if (Controller)
+    {
+        Controller->SetControlRotation(FRotator(0.0f, StartTransform.Rotator().Yaw, 0.0f));
+    }
+}
@@ -5,9 +5,14 @@
 #include "Kismet/GameplayStatics.h"
 #include "Materials/MaterialInstanceDynamic.h"
 #include "Sound/SoundBase.h"
+#include "WTowerGameInstance.h"
+#include "Audio/WAudioManager.h"
+#include "WTowerStats.h"
+#include "WTowerMemory.h"
 
 APowerUpActor::APowerUpActor()
 {
+    LLM_SCOPE_BYTAG(Tower_PowerUps);
     PrimaryActorTick.bCanEverTick = true;
 
     // Создаем компоненты
@@ -32,11 +37,14 @@ APowerUpActor::APowerUpActor()
     HoverAmplitude = 10.0f;
     HoverFrequency = 2.0f;
     TimeElapsed = 0.0f;
+    bCollected = false;
 }
 
 void APowerUpActor::BeginPlay()
 {
+    LLM_SCOPE_BYTAG(Tower_PowerUps);
     Super::BeginPlay();
+    INC_DWORD_STAT(STAT_TowerLivePowerUpActors);
 
     // Сохраняем начальное положение для эффекта парения
     InitialLocation = GetActorLocation();
@@ -53,8 +61,15 @@ void APowerUpActor::BeginPlay()
     UpdateVisuals();
 }
 
+void APowerUpActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    DEC_DWORD_STAT(STAT_TowerLivePowerUpActors);
+    Super::EndPlay(EndPlayReason);
+}
+
 void APowerUpActor::Tick(float DeltaTime)
 {
+    WTOWER_SCOPE_TICK(STAT_TowerPowerUpActorTick, PowerUps);
     Super::Tick(DeltaTime);
 
     // Вращение
@@ -77,13 +92,17 @@ void APowerUpActor::OnOverlapBegin(UPrimitiveComponent* OverlappedComp, AActor*
 {
     // Проверяем, что пересечение произошло с игроком
     ABaruCharacter* Character = Cast<ABaruCharacter>(OtherActor);
-    if (Character)
+    if (Character && !bCollected)
     {
         // Применяем усиление
         PowerUpComponent->ApplyPowerUp(Character);
 
-        // Проигрываем звук подбора (можно добавить в UPowerUpComponent)
-        UGameplayStatics::PlaySound2D(this, nullptr); // Здесь нужно задать звук в BP
+        // Проигрываем звук подбора через аудиокэш: незагруженный звук не грузится синхронно
+        UWTowerGameInstance* GameInstance = Cast<UWTowerGameInstance>(GetGameInstance());
+        if (GameInstance && GameInstance->GetAudioManager())
+        {
+            GameInstance->GetAudioManager()->PlayCachedSound(PickupSound, GetActorLocation(), EWSoundCategory::PowerUp);
+        }
 
         // Создаем эффект подбора
         UGameplayStatics::SpawnEmitterAtLocation(
@@ -94,13 +113,30 @@ void APowerUpActor::OnOverlapBegin(UPrimitiveComponent* OverlappedComp, AActor*
             true
         );
 
-        // Уничтожаем объект усиления
-        Destroy();
+        // Скрываем объект усиления, он вернется при перезапуске забега
+        SetCollected(true);
     }
 }
 
+void APowerUpActor::ResetPowerUp()
+{
+    TimeElapsed = 0.0f;
+    SetActorLocation(InitialLocation);
+    SetCollected(false);
+}
+
+void APowerUpActor::SetCollected(bool bNewCollected)
+{
+    bCollected = bNewCollected;
+    SetActorHiddenInGame(bNewCollected);
+    SetActorEnableCollision(!bNewCollected);
+    SetActorTickEnabled(!bNewCollected);
+}
+
 void APowerUpActor::UpdateVisuals()
 {
+    LLM_SCOPE_BYTAG(Tower_PowerUps);
+
     UMaterialInstanceDynamic* DynamicMaterial = nullptr;
 
     // Устанавливаем базовую сферическую геометрию если не установлена
@@ -6,6 +6,8 @@
 #include "PowerUpComponent.h"
 #include "PowerUpActor.generated.h"
 
+class USoundBase;
+
 UCLASS()
 class TOWER_API APowerUpActor : public AActor
 {
@@ -44,8 +46,21 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Visual")
     float HoverFrequency;
 
+    // Звук подбора (объявляется в AudioCues уровня, чтобы быть загруженным заранее)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Audio")
+    TSoftObjectPtr<USoundBase> PickupSound;
+
+    // Вернуть подобранное усиление на место (мягкий перезапуск забега)
+    UFUNCTION(BlueprintCallable, Category = "Power-Up")
+    void ResetPowerUp();
+
+    // Подобрано ли усиление в текущем забеге
+    UFUNCTION(BlueprintCallable, Category = "Power-Up")
+    bool IsCollected() const { return bCollected; }
+
 protected:
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
     virtual void Tick(float DeltaTime) override;
 
     // Обработка столкновений
@@ -60,4 +75,9 @@ protected:
     // Хранение начальной позиции для эффекта парения
     FVector InitialLocation;
     float TimeElapsed;
+
+    // Подобранное усиление скрыто, но остается в мире до перезапуска
+    bool bCollected;
+
+    void SetCollected(bool bNewCollected);
 };
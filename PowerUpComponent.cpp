@@ -3,6 +3,11 @@
 #include "PowerUpComponent.h"
 #include "BaruCharacter.h"
 #include "GameManager.h"
+#include "WTowerGameInstance.h"
+#include "Collectibles/WCollectibleField.h"
+#include "Gameplay/WTowerRunSubsystem.h"
+#include "WTowerStats.h"
+#include "WTowerMemory.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "Kismet/GameplayStatics.h"
 #include "Components/CapsuleComponent.h"
@@ -42,6 +47,17 @@ void UPowerUpComponent::InitializePowerUpColors()
     }
 }
 
+float UPowerUpComponent::GetJumpBoostMultiplier(float InStrength)
+{
+    return 1.0f + InStrength;
+}
+
+float UPowerUpComponent::GetSlowFallGravityScale(float InStrength)
+{
+    // Сила 1 почти отключает гравитацию, но не до нуля
+    return 1.0f - FMath::Clamp(InStrength, 0.1f, 0.9f);
+}
+
 void UPowerUpComponent::BeginPlay()
 {
     Super::BeginPlay();
@@ -60,6 +76,8 @@ void UPowerUpComponent::BeginPlay()
 
 void UPowerUpComponent::ApplyPowerUp(AActor* Target)
 {
+    WTOWER_SCOPE_CYCLE(STAT_TowerApplyPowerUp);
+
     if (!ensure(Target))
     {
         UE_LOG(LogTemp, Warning, TEXT("PowerUpComponent: Invalid target for power-up"));
@@ -95,11 +113,17 @@ void UPowerUpComponent::ApplyPowerUp(AActor* Target)
         );
     }
 
+    // Учитываем усиление в статистике забега
+    if (UWTowerRunSubsystem* Run = UWTowerRunSubsystem::Get(Character))
+    {
+        Run->NotifyPowerUpUsed(PowerUpType);
+    }
+
     // Применяем эффект усиления
     switch (PowerUpType)
     {
     case EPowerUpType::ExtraJump:
-        Character->ActivateJumpBoost(1.0f + Strength, Duration);
+        Character->ActivateJumpBoost(GetJumpBoostMultiplier(Strength), Duration);
         break;
 
     case EPowerUpType::SpeedBoost:
@@ -112,6 +136,7 @@ void UPowerUpComponent::ApplyPowerUp(AActor* Target)
 
     case EPowerUpType::Magnet:
         Character->ActivateMagnet(Duration);
+        AWCollectibleField::ActivateMagnetInWorld(Character, Duration);
         break;
 
     case EPowerUpType::Rocket:
@@ -119,7 +144,7 @@ void UPowerUpComponent::ApplyPowerUp(AActor* Target)
         break;
 
     case EPowerUpType::SlowFall:
-        Character->ActivateSlowFall(1.0f - FMath::Clamp(Strength, 0.1f, 0.9f), Duration);
+        Character->ActivateSlowFall(GetSlowFallGravityScale(Strength), Duration);
         break;
     case EPowerUpType::ScoreBonus:
     {
@@ -139,6 +164,17 @@ void UPowerUpComponent::ApplyPowerUp(AActor* Target)
         {
             GameManager->PlayerWon();
         }
+
+        // Записываем забег в историю; отсчет времени перехода на следующий уровень начинается с победы
+        if (UWTowerGameInstance* GI = Cast<UWTowerGameInstance>(Character->GetGameInstance()))
+        {
+            GI->RecordCompletedRun();
+
+            if (UWLevelTransitionService* Transition = GI->GetLevelTransitionService())
+            {
+                Transition->MarkVictory();
+            }
+        }
         break;
     }
     default:
@@ -173,6 +209,8 @@ FLinearColor UPowerUpComponent::GetColorForPowerUpType(EPowerUpType Type)
 
 void UPowerUpComponent::UpdateVisualEffects(UStaticMeshComponent* TargetMesh)
 {
+    LLM_SCOPE_BYTAG(Tower_PowerUps);
+
     if (!TargetMesh)
         return;
 
@@ -36,6 +36,11 @@ public:
     // Метод для настройки визуальных эффектов
     void UpdateVisualEffects(UStaticMeshComponent* TargetMesh);
 
+    // Множитель прыжка ExtraJump и множитель гравитации SlowFall для заданной силы усиления
+    // (общие для применения усиления и таблиц достижимости платформ)
+    static float GetJumpBoostMultiplier(float InStrength);
+    static float GetSlowFallGravityScale(float InStrength);
+
     // Основные параметры усиления
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Power Up")
     EPowerUpType PowerUpType;
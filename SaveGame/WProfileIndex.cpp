@@ -0,0 +1,199 @@
+#include "WProfileIndex.h"
+#include "WSaveService.h"
+#include "WTowerSaveGame.h"
+#include "Async/Async.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+UWProfileIndex::UWProfileIndex()
+{
+    // Инициализация по умолчанию
+    SaveDelay = 2.0f;
+}
+
+FString UWProfileIndex::GetIndexFilePath()
+{
+    return FPaths::ProjectSavedDir() / TEXT("SaveGames") / TEXT("Profiles.idx");
+}
+
+//----------------------------------------------------------------------------------------
+// ЧТЕНИЕ И ЗАПИСЬ
+//----------------------------------------------------------------------------------------
+
+void UWProfileIndex::LoadIndex()
+{
+    Profiles.Reset();
+    LastSlot.Reset();
+
+    TArray<uint8> Bytes;
+    if (FFileHelper::LoadFileToArray(Bytes, *GetIndexFilePath(), FILEREAD_Silent))
+    {
+        FMemoryReader Reader(Bytes);
+        uint32 Magic = 0;
+        uint32 Version = 0;
+        Reader << Magic << Version;
+        if (Magic == IndexMagic && Version == IndexVersion)
+        {
+            Reader << LastSlot << Profiles;
+        }
+
+        if (Reader.IsError() || Magic != IndexMagic || Version != IndexVersion)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("WProfileIndex: Index file is invalid, rebuilding from slots"));
+            Profiles.Reset();
+            LastSlot.Reset();
+        }
+    }
+
+    if (Profiles.Num() == 0)
+    {
+        ImportExistingSlots();
+    }
+
+    if (!FindProfile(LastSlot))
+    {
+        LastSlot = Profiles.Num() > 0 ? Profiles[0].SlotName : FString();
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("WProfileIndex: %d profiles, last slot '%s'"), Profiles.Num(), *LastSlot);
+}
+
+void UWProfileIndex::ImportExistingSlots()
+{
+    // Имена и прогресс уточнятся при первой загрузке слота, здесь читаются только имена файлов
+    const FString SaveDir = FPaths::GetPath(GetIndexFilePath());
+    TArray<FString> SlotFiles;
+    IFileManager::Get().FindFiles(SlotFiles, *(SaveDir / TEXT("*.sav")), true, false);
+
+    for (const FString& File : SlotFiles)
+    {
+        FWProfileHeader& Header = Profiles.AddDefaulted_GetRef();
+        Header.SlotName = FPaths::GetBaseFilename(File);
+        Header.UserName = TEXT("Player");
+        Header.SaveDate = IFileManager::Get().GetTimeStamp(*(SaveDir / File));
+    }
+}
+
+void UWProfileIndex::SaveIndex()
+{
+    // Прямая запись заменяет отложенную
+    if (DeferredSaveHandle.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(DeferredSaveHandle);
+        DeferredSaveHandle.Reset();
+    }
+
+    TArray<uint8> Bytes;
+    FMemoryWriter Writer(Bytes);
+    uint32 Magic = IndexMagic;
+    uint32 Version = IndexVersion;
+    Writer << Magic << Version << LastSlot << Profiles;
+
+    // Файл маленький, но записи должны идти по порядку
+    if (PendingWrite.IsValid())
+    {
+        PendingWrite.Wait();
+    }
+
+    const FString FilePath = GetIndexFilePath();
+    PendingWrite = Async(EAsyncExecution::ThreadPool, [FilePath, Bytes = MoveTemp(Bytes)]()
+    {
+        if (!UWSaveService::WriteFileAtomic(FilePath, Bytes))
+        {
+            UE_LOG(LogTemp, Error, TEXT("WProfileIndex: Failed to write %s"), *FilePath);
+        }
+    });
+}
+
+void UWProfileIndex::RequestSave()
+{
+    if (DeferredSaveHandle.IsValid())
+        return;
+
+    TWeakObjectPtr<UWProfileIndex> WeakThis(this);
+    DeferredSaveHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([WeakThis](float DeltaTime)
+        {
+            if (UWProfileIndex* Index = WeakThis.Get())
+            {
+                Index->DeferredSaveHandle.Reset();
+                Index->SaveIndex();
+            }
+            return false;
+        }), SaveDelay);
+}
+
+void UWProfileIndex::Shutdown()
+{
+    // Отложенная запись выполняется сразу
+    if (DeferredSaveHandle.IsValid())
+    {
+        SaveIndex();
+    }
+
+    if (PendingWrite.IsValid())
+    {
+        PendingWrite.Wait();
+    }
+}
+
+//----------------------------------------------------------------------------------------
+// ПРОФИЛИ
+//----------------------------------------------------------------------------------------
+
+const FWProfileHeader* UWProfileIndex::FindProfile(const FString& SlotName) const
+{
+    return Profiles.FindByPredicate([&SlotName](const FWProfileHeader& Header)
+        {
+            return Header.SlotName == SlotName;
+        });
+}
+
+FString UWProfileIndex::AddProfile(const FString& UserName, const FSoftObjectPath& Thumbnail)
+{
+    // Слоты не используются повторно, даже если файл удален вручную
+    FString SlotName;
+    for (int32 Number = Profiles.Num() + 1; ; ++Number)
+    {
+        SlotName = FString::Printf(TEXT("Profile%d"), Number);
+        if (!FindProfile(SlotName) && !IFileManager::Get().FileExists(*UWSaveService::GetSlotFilePath(SlotName)))
+        {
+            break;
+        }
+    }
+
+    FWProfileHeader& Header = Profiles.AddDefaulted_GetRef();
+    Header.SlotName = SlotName;
+    Header.UserName = UserName;
+    Header.SaveDate = FDateTime::Now();
+    Header.Thumbnail = Thumbnail;
+
+    return SlotName;
+}
+
+bool UWProfileIndex::UpdateProfile(const FString& SlotName, const UWTowerSaveGame* SaveGame, int32 NumPlayableLevels)
+{
+    if (!SaveGame)
+        return false;
+
+    FWProfileHeader* Header = const_cast<FWProfileHeader*>(FindProfile(SlotName));
+    const bool bAdded = Header == nullptr;
+    if (bAdded)
+    {
+        Header = &Profiles.AddDefaulted_GetRef();
+        Header->SlotName = SlotName;
+    }
+
+    Header->UserName = SaveGame->GetUserName();
+    // Дата в заголовке может быть новее снимка: ее обновляет и дозапись журнала
+    Header->SaveDate = FMath::Max(Header->SaveDate, SaveGame->GetSaveDate());
+    Header->TotalProgress = NumPlayableLevels > 0
+        ? FMath::Clamp(static_cast<float>(SaveGame->GetCompletedLevelCount()) / NumPlayableLevels, 0.0f, 1.0f)
+        : 0.0f;
+    Header->TotalBestScore = SaveGame->GetTotalBestScore();
+    Header->Thumbnail = SaveGame->GetThumbnail();
+
+    return bAdded;
+}
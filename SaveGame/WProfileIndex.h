@@ -0,0 +1,126 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "Async/Future.h"
+#include "Containers/Ticker.h"
+#include "WProfileIndex.generated.h"
+
+class UWTowerSaveGame;
+
+// Профиль загружен и стал текущим (имя слота, успех)
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnWProfileLoaded, const FString&, SlotName, bool, bSuccess);
+
+/**
+ * Заголовок профиля: все, что нужно экрану выбора профиля, без загрузки самого слота
+ */
+USTRUCT(BlueprintType)
+struct FWProfileHeader
+{
+    GENERATED_BODY()
+
+    // Слот сохранения профиля
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Профиль")
+    FString SlotName;
+
+    // Имя пользователя
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Профиль")
+    FString UserName;
+
+    // Дата последнего сохранения
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Профиль")
+    FDateTime SaveDate;
+
+    // Доля пройденных уровней (0.0 - 1.0)
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Профиль")
+    float TotalProgress;
+
+    // Сумма лучших счетов по уровням
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Профиль")
+    int32 TotalBestScore;
+
+    // Миниатюра профиля (загружается экраном выбора асинхронно)
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Профиль")
+    FSoftObjectPath Thumbnail;
+
+    FWProfileHeader()
+        : TotalProgress(0.0f)
+        , TotalBestScore(0)
+    {
+    }
+
+    friend FArchive& operator<<(FArchive& Ar, FWProfileHeader& Header)
+    {
+        return Ar << Header.SlotName << Header.UserName << Header.SaveDate
+            << Header.TotalProgress << Header.TotalBestScore << Header.Thumbnail;
+    }
+};
+
+/**
+ * Индекс профилей.
+ * Небольшой файл Profiles.idx рядом со слотами хранит заголовки всех профилей
+ * и последний выбранный слот. Экран выбора читает только его, полный слот
+ * загружается лишь при выборе профиля. Заголовок обновляется после каждой записи слота
+ * и дозаписи журнала; во втором случае файл индекса пишется с задержкой, одной записью на серию событий.
+ */
+UCLASS()
+class WTOWER_API UWProfileIndex : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    UWProfileIndex();
+
+    // Прочитать индекс. Не создает UObject и может выполняться на рабочем потоке
+    void LoadIndex();
+
+    // Дождаться фоновой записи
+    void Shutdown();
+
+    // Записать индекс (снимок делается сразу, запись на диск в фоне)
+    void SaveIndex();
+
+    // Записать индекс через SaveDelay секунд; запросы до записи объединяются
+    void RequestSave();
+
+    // Задержка отложенной записи индекса (секунды)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Профили")
+    float SaveDelay;
+
+    // Все профили
+    UFUNCTION(BlueprintCallable, Category = "Профили")
+    TArray<FWProfileHeader> GetProfiles() const { return Profiles; }
+
+    // Найти заголовок профиля по слоту
+    const FWProfileHeader* FindProfile(const FString& SlotName) const;
+
+    // Добавить профиль с новым уникальным слотом, возвращает имя слота
+    FString AddProfile(const FString& UserName, const FSoftObjectPath& Thumbnail);
+
+    // Обновить заголовок по данным сохранения (профиль добавляется, если его нет).
+    // Возвращает true, если профиль был добавлен
+    bool UpdateProfile(const FString& SlotName, const UWTowerSaveGame* SaveGame, int32 NumPlayableLevels);
+
+    // Последний выбранный слот (пустая строка, если профилей нет)
+    const FString& GetLastSlot() const { return LastSlot; }
+    void SetLastSlot(const FString& SlotName) { LastSlot = SlotName; }
+
+    // Путь к файлу индекса
+    static FString GetIndexFilePath();
+
+private:
+    static constexpr uint32 IndexMagic = 0x50525457; // "WTRP"
+    static constexpr uint32 IndexVersion = 1;
+
+    TArray<FWProfileHeader> Profiles;
+    FString LastSlot;
+
+    // Фоновая запись
+    TFuture<void> PendingWrite;
+
+    // Отложенная запись
+    FTSTicker::FDelegateHandle DeferredSaveHandle;
+
+    // Индекса еще нет: подхватить слоты, сохраненные до появления профилей
+    void ImportExistingSlots();
+};
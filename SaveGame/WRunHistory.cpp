@@ -0,0 +1,443 @@
+#include "WRunHistory.h"
+#include "WSaveService.h"
+#include "Async/Async.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace
+{
+    // Заголовок файла истории
+    struct FRunHistoryHeader
+    {
+        uint32 Magic;
+        uint32 Version;
+        uint32 RecordSize;
+        uint32 Reserved;
+    };
+
+    constexpr int64 HistoryHeaderSize = sizeof(FRunHistoryHeader);
+
+    // Сколько записей читать за раз при перестройке индекса
+    constexpr int32 RebuildChunkRecords = 1024;
+}
+
+float FWRunRecord::GetMetric(EWRunMetric Metric) const
+{
+    switch (Metric)
+    {
+    case EWRunMetric::Time: return Time;
+    case EWRunMetric::Score: return static_cast<float>(Score);
+    case EWRunMetric::MaxHeight: return MaxHeight;
+    }
+    return 0.0f;
+}
+
+//----------------------------------------------------------------------------------------
+// СТРУКТУРЫ ИНДЕКСА
+//----------------------------------------------------------------------------------------
+
+void UWRunHistory::FHistogram::Add(int32 Bucket)
+{
+    if (Tree.Num() == 0)
+    {
+        Tree.SetNumZeroed(HistogramBuckets + 1);
+    }
+
+    for (int32 Index = Bucket + 1; Index <= HistogramBuckets; Index += Index & -Index)
+    {
+        ++Tree[Index];
+    }
+    ++Total;
+}
+
+int32 UWRunHistory::FHistogram::FindBucket(uint32 Rank) const
+{
+    // Спуск по дереву: наименьшая корзина, в которой накопленное количество достигает Rank
+    int32 Position = 0;
+    for (int32 Step = HistogramBuckets; Step > 0; Step >>= 1)
+    {
+        const int32 Next = Position + Step;
+        if (Next <= HistogramBuckets && Tree[Next] < Rank)
+        {
+            Position = Next;
+            Rank -= Tree[Next];
+        }
+    }
+    return Position;
+}
+
+void UWRunHistory::FRollingRing::Add(float Value)
+{
+    if (Values.Num() < RollingWindow)
+    {
+        Values.Add(Value);
+    }
+    else
+    {
+        Sum -= Values[Head];
+        Values[Head] = Value;
+        Head = (Head + 1) % RollingWindow;
+    }
+    Sum += Value;
+}
+
+//----------------------------------------------------------------------------------------
+// ИНИЦИАЛИЗАЦИЯ
+//----------------------------------------------------------------------------------------
+
+UWRunHistory::UWRunHistory()
+{
+    // Инициализация по умолчанию
+    TotalRecords = 0;
+}
+
+void UWRunHistory::Initialize(const FString& InSlotName)
+{
+    SlotName = InSlotName;
+
+    const FString SlotPath = UWSaveService::GetSlotFilePath(InSlotName);
+    HistoryPath = FPaths::ChangeExtension(SlotPath, TEXT("runs"));
+    IndexPath = FPaths::ChangeExtension(SlotPath, TEXT("runidx"));
+}
+
+void UWRunHistory::LoadIndex()
+{
+    // Количество целых записей в файле (недописанный хвост игнорируется)
+    uint32 RecordsOnDisk = 0;
+    const int64 FileSize = IFileManager::Get().FileSize(*HistoryPath);
+    if (FileSize > HistoryHeaderSize)
+    {
+        RecordsOnDisk = static_cast<uint32>((FileSize - HistoryHeaderSize) / sizeof(FWRunRecord));
+
+        // Иначе следующие записи легли бы со сдвигом
+        const int64 ValidSize = HistoryHeaderSize + static_cast<int64>(RecordsOnDisk) * sizeof(FWRunRecord);
+        if (ValidSize != FileSize)
+        {
+            TruncateTornTail(ValidSize);
+        }
+    }
+
+    if (!ReadIndexFile() || TotalRecords > RecordsOnDisk)
+    {
+        // Индекса нет или он не соответствует истории: строим заново потоково
+        Levels.Reset();
+        TotalRecords = 0;
+    }
+
+    if (TotalRecords < RecordsOnDisk)
+    {
+        RebuildIndexFrom(TotalRecords);
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("WRunHistory: %u runs indexed for slot %s"), TotalRecords, *SlotName);
+}
+
+void UWRunHistory::Shutdown()
+{
+    WaitForPendingWrite();
+}
+
+void UWRunHistory::WaitForPendingWrite() const
+{
+    if (PendingWrite.IsValid())
+    {
+        PendingWrite.Wait();
+    }
+}
+
+bool UWRunHistory::ReadIndexFile()
+{
+    TArray<uint8> Bytes;
+    if (!FFileHelper::LoadFileToArray(Bytes, *IndexPath, FILEREAD_Silent))
+    {
+        return false;
+    }
+
+    FMemoryReader Reader(Bytes);
+    uint32 Magic = 0;
+    uint32 Version = 0;
+    int32 Buckets = 0;
+    Reader << Magic << Version << Buckets;
+    if (Magic != IndexMagic || Version != FormatVersion || Buckets != HistogramBuckets)
+    {
+        return false;
+    }
+
+    Reader << TotalRecords;
+    Reader << Levels;
+    return !Reader.IsError();
+}
+
+void UWRunHistory::RebuildIndexFrom(uint32 FirstRecord)
+{
+    TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*HistoryPath));
+    if (!Reader)
+    {
+        return;
+    }
+
+    FRunHistoryHeader Header;
+    Reader->Serialize(&Header, HistoryHeaderSize);
+    if (Header.Magic != HistoryMagic || Header.RecordSize != sizeof(FWRunRecord))
+    {
+        UE_LOG(LogTemp, Error, TEXT("WRunHistory: Unsupported history file %s"), *HistoryPath);
+        return;
+    }
+
+    const uint32 RecordsOnDisk = static_cast<uint32>((Reader->TotalSize() - HistoryHeaderSize) / sizeof(FWRunRecord));
+    Reader->Seek(HistoryHeaderSize + static_cast<int64>(FirstRecord) * sizeof(FWRunRecord));
+
+    // Читаем блоками, чтобы не держать всю историю в памяти
+    TArray<FWRunRecord> Chunk;
+    for (uint32 RecordIndex = FirstRecord; RecordIndex < RecordsOnDisk; )
+    {
+        const int32 NumToRead = static_cast<int32>(FMath::Min<uint32>(RebuildChunkRecords, RecordsOnDisk - RecordIndex));
+        Chunk.SetNumUninitialized(NumToRead, false);
+        Reader->Serialize(Chunk.GetData(), NumToRead * sizeof(FWRunRecord));
+
+        for (const FWRunRecord& Record : Chunk)
+        {
+            AddToIndex(Record, RecordIndex++);
+        }
+    }
+    TotalRecords = RecordsOnDisk;
+
+    UE_LOG(LogTemp, Log, TEXT("WRunHistory: Indexed %u runs from %s"), RecordsOnDisk - FirstRecord, *HistoryPath);
+}
+
+void UWRunHistory::TruncateTornTail(int64 ValidSize)
+{
+    UE_LOG(LogTemp, Warning, TEXT("WRunHistory: Dropping torn record at the end of %s"), *HistoryPath);
+
+    // Копируем целые записи во временный файл блоками и заменяем исходный
+    const FString TempPath = HistoryPath + TEXT(".tmp");
+    {
+        TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*HistoryPath));
+        TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*TempPath));
+        if (!Reader || !Writer)
+        {
+            return;
+        }
+
+        TArray<uint8> Buffer;
+        Buffer.SetNumUninitialized(RebuildChunkRecords * sizeof(FWRunRecord));
+        for (int64 Offset = 0; Offset < ValidSize; )
+        {
+            const int64 NumBytes = FMath::Min<int64>(Buffer.Num(), ValidSize - Offset);
+            Reader->Serialize(Buffer.GetData(), NumBytes);
+            Writer->Serialize(Buffer.GetData(), NumBytes);
+            Offset += NumBytes;
+        }
+    }
+    IFileManager::Get().Move(*HistoryPath, *TempPath, true, true);
+}
+
+//----------------------------------------------------------------------------------------
+// ДОБАВЛЕНИЕ
+//----------------------------------------------------------------------------------------
+
+void UWRunHistory::AppendRun(const FWRunRecord& Record)
+{
+    const uint32 RecordIndex = TotalRecords++;
+    AddToIndex(Record, RecordIndex);
+
+    // Индекс сериализуется на игровом потоке, на диск пишется в фоне
+    TArray<uint8> IndexBytes = SerializeIndex();
+
+    // Записи выполняются по порядку: дожидаемся предыдущей
+    if (PendingWrite.IsValid())
+    {
+        PendingWrite.Wait();
+    }
+
+    PendingWrite = Async(EAsyncExecution::ThreadPool,
+        [HistoryFile = HistoryPath, IndexFile = IndexPath, Record, IndexBytes = MoveTemp(IndexBytes)]()
+        {
+            IFileManager& FileManager = IFileManager::Get();
+            const bool bNewFile = FileManager.FileSize(*HistoryFile) < HistoryHeaderSize;
+
+            TUniquePtr<FArchive> Writer(FileManager.CreateFileWriter(*HistoryFile, bNewFile ? 0 : FILEWRITE_Append));
+            if (!Writer)
+            {
+                UE_LOG(LogTemp, Error, TEXT("WRunHistory: Failed to open %s"), *HistoryFile);
+                return;
+            }
+
+            if (bNewFile)
+            {
+                FRunHistoryHeader Header = { HistoryMagic, FormatVersion, sizeof(FWRunRecord), 0 };
+                Writer->Serialize(&Header, HistoryHeaderSize);
+            }
+
+            FWRunRecord RecordCopy = Record;
+            Writer->Serialize(&RecordCopy, sizeof(FWRunRecord));
+            Writer->Close();
+
+            // Индекс заменяется атомарно; если запись не дойдет, он будет дополнен по истории при загрузке
+            const FString TempFile = IndexFile + TEXT(".tmp");
+            if (FFileHelper::SaveArrayToFile(IndexBytes, *TempFile))
+            {
+                FileManager.Move(*IndexFile, *TempFile, true, true);
+            }
+        });
+}
+
+TArray<uint8> UWRunHistory::SerializeIndex()
+{
+    TArray<uint8> Bytes;
+    FMemoryWriter Writer(Bytes);
+
+    uint32 Magic = IndexMagic;
+    uint32 Version = FormatVersion;
+    int32 Buckets = HistogramBuckets;
+    Writer << Magic << Version << Buckets;
+    Writer << TotalRecords;
+    Writer << Levels;
+
+    return Bytes;
+}
+
+void UWRunHistory::AddToIndex(const FWRunRecord& Record, uint32 RecordIndex)
+{
+    if (!Levels.IsValidIndex(Record.LevelId))
+    {
+        Levels.SetNum(Record.LevelId + 1);
+    }
+
+    FLevelIndex& Level = Levels[Record.LevelId];
+    ++Level.RunCount;
+
+    for (int32 MetricIndex = 0; MetricIndex < NumMetrics; ++MetricIndex)
+    {
+        const EWRunMetric Metric = static_cast<EWRunMetric>(MetricIndex);
+        const float Value = Record.GetMetric(Metric);
+        FMetricIndex& Index = Level.Metrics[MetricIndex];
+
+        const int32 Bucket = FMath::Clamp(FMath::FloorToInt(Value / GetBucketWidth(Metric)), 0, HistogramBuckets - 1);
+        Index.Histogram.Add(Bucket);
+        Index.Rolling.Add(Value);
+
+        // Список лучших короткий и отсортирован от лучшего к худшему
+        int32 InsertAt = 0;
+        while (InsertAt < Index.Top.Num() && !IsBetter(Metric, Value, Index.Top[InsertAt].Value))
+        {
+            ++InsertAt;
+        }
+        if (InsertAt < MaxTopRuns)
+        {
+            FTopEntry Entry;
+            Entry.Value = Value;
+            Entry.RecordIndex = RecordIndex;
+            Index.Top.Insert(Entry, InsertAt);
+            if (Index.Top.Num() > MaxTopRuns)
+            {
+                Index.Top.Pop(false);
+            }
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------
+// ЗАПРОСЫ
+//----------------------------------------------------------------------------------------
+
+int32 UWRunHistory::GetRunCount(int32 LevelId) const
+{
+    return Levels.IsValidIndex(LevelId) ? static_cast<int32>(Levels[LevelId].RunCount) : 0;
+}
+
+float UWRunHistory::GetPercentile(int32 LevelId, EWRunMetric Metric, float Percentile) const
+{
+    if (!Levels.IsValidIndex(LevelId))
+        return 0.0f;
+
+    const FHistogram& Histogram = Levels[LevelId].Metrics[static_cast<int32>(Metric)].Histogram;
+    if (Histogram.Total == 0)
+        return 0.0f;
+
+    const uint32 Rank = FMath::Clamp<uint32>(FMath::CeilToInt(FMath::Clamp(Percentile, 0.0f, 1.0f) * Histogram.Total), 1, Histogram.Total);
+    const int32 Bucket = Histogram.FindBucket(Rank);
+
+    // Середина корзины
+    return (Bucket + 0.5f) * GetBucketWidth(Metric);
+}
+
+float UWRunHistory::GetRollingAverage(int32 LevelId, EWRunMetric Metric) const
+{
+    if (!Levels.IsValidIndex(LevelId))
+        return 0.0f;
+
+    const FRollingRing& Ring = Levels[LevelId].Metrics[static_cast<int32>(Metric)].Rolling;
+    return Ring.Values.Num() > 0 ? static_cast<float>(Ring.Sum / Ring.Values.Num()) : 0.0f;
+}
+
+TArray<FWRunRecord> UWRunHistory::GetTopRuns(int32 LevelId, EWRunMetric Metric, int32 Count) const
+{
+    TArray<FWRunRecord> Result;
+    if (!Levels.IsValidIndex(LevelId))
+        return Result;
+
+    const TArray<FTopEntry>& Top = Levels[LevelId].Metrics[static_cast<int32>(Metric)].Top;
+    const int32 NumToRead = FMath::Min(Count, Top.Num());
+    if (NumToRead <= 0)
+        return Result;
+
+    // Лучший забег часто только что добавлен и еще пишется в фоне
+    WaitForPendingWrite();
+
+    TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*HistoryPath));
+    if (!Reader)
+        return Result;
+
+    // Каждая запись читается одним переходом по смещению; непрочитанные записи не возвращаются
+    Result.Reserve(NumToRead);
+    for (int32 Index = 0; Index < NumToRead; ++Index)
+    {
+        FWRunRecord Record;
+        Reader->Seek(HistoryHeaderSize + static_cast<int64>(Top[Index].RecordIndex) * sizeof(FWRunRecord));
+        Reader->Serialize(&Record, sizeof(FWRunRecord));
+        if (Reader->IsError())
+        {
+            UE_LOG(LogTemp, Warning, TEXT("WRunHistory: Failed to read record %u from %s"), Top[Index].RecordIndex, *HistoryPath);
+            break;
+        }
+        Result.Add(Record);
+    }
+    return Result;
+}
+
+bool UWRunHistory::ReadRecord(uint32 RecordIndex, FWRunRecord& OutRecord) const
+{
+    if (RecordIndex >= TotalRecords)
+        return false;
+
+    WaitForPendingWrite();
+
+    TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*HistoryPath));
+    if (!Reader)
+        return false;
+
+    Reader->Seek(HistoryHeaderSize + static_cast<int64>(RecordIndex) * sizeof(FWRunRecord));
+    Reader->Serialize(&OutRecord, sizeof(FWRunRecord));
+    return !Reader->IsError();
+}
+
+float UWRunHistory::GetBucketWidth(EWRunMetric Metric)
+{
+    switch (Metric)
+    {
+    case EWRunMetric::Time: return 0.25f;       // 0.25 с, до ~17 минут
+    case EWRunMetric::Score: return 10.0f;      // 10 очков, до 40960
+    case EWRunMetric::MaxHeight: return 100.0f; // 1 м, до 4 км
+    }
+    return 1.0f;
+}
+
+bool UWRunHistory::IsBetter(EWRunMetric Metric, float A, float B)
+{
+    // Время лучше меньшее, остальные показатели - большие
+    return Metric == EWRunMetric::Time ? A < B : A > B;
+}
@@ -0,0 +1,205 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "Async/Future.h"
+#include "WRunHistory.generated.h"
+
+// Показатель забега для запросов к истории
+UENUM(BlueprintType)
+enum class EWRunMetric : uint8
+{
+    Time UMETA(DisplayName = "Time"),
+    Score UMETA(DisplayName = "Score"),
+    MaxHeight UMETA(DisplayName = "Max Height")
+};
+
+/**
+ * Запись о завершенном забеге. Хранится в файле истории как есть, фиксированного размера
+ */
+struct FWRunRecord
+{
+    int32 Seed = 0;
+    uint16 LevelId = 0;
+
+    // Битовая маска использованных типов усилений (бит = EPowerUpType)
+    uint16 PowerUpMask = 0;
+
+    float Time = 0.0f;
+    int32 Score = 0;
+    float MaxHeight = 0.0f;
+
+    // Количество подобранных усилений
+    uint16 PowerUpCount = 0;
+    uint16 Reserved = 0;
+
+    // Время завершения (Unix, секунды)
+    int64 Timestamp = 0;
+
+    float GetMetric(EWRunMetric Metric) const;
+};
+static_assert(sizeof(FWRunRecord) == 32, "FWRunRecord is stored on disk and must stay 32 bytes");
+
+/**
+ * История забегов профиля.
+ * Записи добавляются в конец файла <слот>.runs и никогда не переписываются.
+ * Рядом хранится небольшой индекс <слот>.runidx: для каждого уровня и показателя -
+ * дерево Фенвика по квантованным значениям (перцентили за логарифм), короткий список
+ * лучших забегов и кольцо последних значений для скользящего среднего.
+ * Сами записи читаются с диска по номеру, вся история в память не загружается.
+ */
+UCLASS()
+class WTOWER_API UWRunHistory : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    UWRunHistory();
+
+    // Привязать историю к слоту профиля
+    void Initialize(const FString& InSlotName);
+
+    // Прочитать индекс, при необходимости дополнить или перестроить его по файлу истории.
+    // Не создает UObject и может выполняться на рабочем потоке
+    void LoadIndex();
+
+    // Дождаться фоновых записей
+    void Shutdown();
+
+    // Добавить забег (запись в файл и индекс выполняется в фоне)
+    void AppendRun(const FWRunRecord& Record);
+
+    //----------------------------------------------------------------------------------------
+    // ЗАПРОСЫ
+    //----------------------------------------------------------------------------------------
+
+    // Количество забегов на уровне
+    UFUNCTION(BlueprintCallable, Category = "История забегов")
+    int32 GetRunCount(int32 LevelId) const;
+
+    // Значение показателя на заданном перцентиле (0..1), с точностью до шага квантования
+    UFUNCTION(BlueprintCallable, Category = "История забегов")
+    float GetPercentile(int32 LevelId, EWRunMetric Metric, float Percentile) const;
+
+    // Среднее по последним RollingWindow забегам
+    UFUNCTION(BlueprintCallable, Category = "История забегов")
+    float GetRollingAverage(int32 LevelId, EWRunMetric Metric) const;
+
+    // Лучшие забеги уровня по показателю (не больше MaxTopRuns), записи читаются с диска
+    TArray<FWRunRecord> GetTopRuns(int32 LevelId, EWRunMetric Metric, int32 Count) const;
+
+    // Прочитать запись по номеру
+    bool ReadRecord(uint32 RecordIndex, FWRunRecord& OutRecord) const;
+
+    // Общее количество записей в истории
+    UFUNCTION(BlueprintCallable, Category = "История забегов")
+    int32 GetTotalRunCount() const { return static_cast<int32>(TotalRecords); }
+
+    // Размер окна скользящего среднего и длина списка лучших забегов
+    static constexpr int32 RollingWindow = 32;
+    static constexpr int32 MaxTopRuns = 32;
+
+private:
+    static constexpr uint32 HistoryMagic = 0x48525457; // "WTRH"
+    static constexpr uint32 IndexMagic = 0x49525457;   // "WTRI"
+    static constexpr uint32 FormatVersion = 1;
+    static constexpr int32 HistogramBuckets = 4096;
+    static constexpr int32 NumMetrics = 3;
+
+    // Дерево Фенвика по квантованным значениям показателя
+    struct FHistogram
+    {
+        TArray<uint32> Tree;
+        uint32 Total = 0;
+
+        void Add(int32 Bucket);
+        int32 FindBucket(uint32 Rank) const;
+
+        friend FArchive& operator<<(FArchive& Ar, FHistogram& Histogram)
+        {
+            return Ar << Histogram.Tree << Histogram.Total;
+        }
+    };
+
+    // Последние значения показателя
+    struct FRollingRing
+    {
+        TArray<float> Values;
+        int32 Head = 0;
+        double Sum = 0.0;
+
+        void Add(float Value);
+
+        friend FArchive& operator<<(FArchive& Ar, FRollingRing& Ring)
+        {
+            return Ar << Ring.Values << Ring.Head << Ring.Sum;
+        }
+    };
+
+    struct FTopEntry
+    {
+        float Value = 0.0f;
+        uint32 RecordIndex = 0;
+
+        friend FArchive& operator<<(FArchive& Ar, FTopEntry& Entry)
+        {
+            return Ar << Entry.Value << Entry.RecordIndex;
+        }
+    };
+
+    struct FMetricIndex
+    {
+        FHistogram Histogram;
+        FRollingRing Rolling;
+        TArray<FTopEntry> Top;
+
+        friend FArchive& operator<<(FArchive& Ar, FMetricIndex& Index)
+        {
+            return Ar << Index.Histogram << Index.Rolling << Index.Top;
+        }
+    };
+
+    struct FLevelIndex
+    {
+        uint32 RunCount = 0;
+        FMetricIndex Metrics[NumMetrics];
+
+        friend FArchive& operator<<(FArchive& Ar, FLevelIndex& Index)
+        {
+            Ar << Index.RunCount;
+            for (FMetricIndex& Metric : Index.Metrics)
+            {
+                Ar << Metric;
+            }
+            return Ar;
+        }
+    };
+
+    FString SlotName;
+    FString HistoryPath;
+    FString IndexPath;
+
+    // Индекс, индекс массива = идентификатор уровня
+    TArray<FLevelIndex> Levels;
+    uint32 TotalRecords;
+
+    // Фоновая запись
+    TFuture<void> PendingWrite;
+
+    // Дождаться фоновой дозаписи, прежде чем читать записи с диска
+    void WaitForPendingWrite() const;
+
+    // Шаг квантования показателя в гистограмме
+    static float GetBucketWidth(EWRunMetric Metric);
+
+    // Лучше ли значение A значения B для показателя
+    static bool IsBetter(EWRunMetric Metric, float A, float B);
+
+    void AddToIndex(const FWRunRecord& Record, uint32 RecordIndex);
+    void RebuildIndexFrom(uint32 FirstRecord);
+
+    // Отрезать недописанную запись в конце файла (после аварийного завершения)
+    void TruncateTornTail(int64 ValidSize);
+    bool ReadIndexFile();
+    TArray<uint8> SerializeIndex();
+};
@@ -0,0 +1,382 @@
+#include "WSaveJournal.h"
+#include "WSaveService.h"
+#include "WTowerSaveGame.h"
+#include "../WTowerStats.h"
+#include "../WTowerMemory.h"
+#include "Async/Async.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+UWSaveJournal::UWSaveJournal()
+{
+    // Инициализация по умолчанию
+    CompactThresholdBytes = 16 * 1024;
+    SaveService = nullptr;
+    SaveGame = nullptr;
+    Generation = 0;
+    JournalBytes = 0;
+    bFlushInFlight = false;
+    SnapshotWritesToWait = 0;
+    WriterState = MakeShared<FWriterState, ESPMode::ThreadSafe>();
+}
+
+void UWSaveJournal::Initialize(UWSaveService* InSaveService)
+{
+    SaveService = InSaveService;
+    SaveService->OnSaveCompleted.AddDynamic(this, &UWSaveJournal::OnSnapshotWritten);
+}
+
+//----------------------------------------------------------------------------------------
+// ОТКРЫТИЕ И ВОССТАНОВЛЕНИЕ
+//----------------------------------------------------------------------------------------
+
+int32 UWSaveJournal::Open(const FString& InSlotName, UWTowerSaveGame* InSaveGame)
+{
+    Close();
+
+    SlotName = InSlotName;
+    SaveGame = InSaveGame;
+    if (!SaveGame)
+        return 0;
+
+    // Снимок уже содержит все журналы до своего поколения
+    const uint32 SnapshotGeneration = static_cast<uint32>(SaveGame->GetJournalGeneration());
+    Generation = SnapshotGeneration;
+    JournalBytes = 0;
+
+    // Размер журналов ограничен порогом уплотнения, поэтому чтение здесь дешевое
+    int32 NumApplied = 0;
+    for (const uint32 FileGeneration : FindJournalGenerations())
+    {
+        if (FileGeneration < SnapshotGeneration)
+            continue;
+
+        TArray<FJournalRecord> Records;
+        int64 ValidSize = 0;
+        if (!ReadJournalFile(GetJournalPath(FileGeneration), Records, ValidSize))
+            continue;
+
+        // Записи задают значения, а не приращения, поэтому повторное применение безопасно
+        for (const FJournalRecord& Record : Records)
+        {
+            ApplyRecord(SaveGame, Record);
+        }
+        NumApplied += Records.Num();
+
+        Generation = FileGeneration;
+        JournalBytes = ValidSize;
+    }
+
+    // Журналы, уже вошедшие в снимок (удаление прервалось в прошлый раз)
+    DeleteJournalsBefore(SnapshotGeneration);
+
+    if (NumApplied > 0)
+    {
+        UE_LOG(LogTemp, Log, TEXT("WSaveJournal: Replayed %d records for slot %s (generation %u)"), NumApplied, *SlotName, Generation);
+    }
+    return NumApplied;
+}
+
+void UWSaveJournal::Close()
+{
+    const bool bHadRecords = bFlushInFlight || PendingRecords.Num() > 0;
+
+    if (PendingFlush.IsValid())
+    {
+        PendingFlush.Wait();
+    }
+
+    // Дописываем оставшиеся записи синхронно
+    if (PendingRecords.Num() > 0 && SaveGame)
+    {
+        StartFlush();
+        PendingFlush.Wait();
+    }
+
+    // Ответ последней записи, если он еще придет, будет проигнорирован
+    bFlushInFlight = false;
+    PendingRecords.Reset();
+    WriterState->Writer.Reset();
+    SnapshotWritesToWait = 0;
+
+    if (bHadRecords && SaveGame)
+    {
+        OnJournalFlushed.Broadcast(SlotName, SaveGame);
+    }
+    SaveGame = nullptr;
+}
+
+FString UWSaveJournal::GetJournalPath(uint32 InGeneration) const
+{
+    const FString SaveDir = FPaths::GetPath(UWSaveService::GetSlotFilePath(SlotName));
+    return SaveDir / FString::Printf(TEXT("%s.%u.journal"), *SlotName, InGeneration);
+}
+
+TArray<uint32> UWSaveJournal::FindJournalGenerations() const
+{
+    const FString SaveDir = FPaths::GetPath(UWSaveService::GetSlotFilePath(SlotName));
+    TArray<FString> Files;
+    IFileManager::Get().FindFiles(Files, *(SaveDir / (SlotName + TEXT(".*.journal"))), true, false);
+
+    TArray<uint32> Generations;
+    for (const FString& File : Files)
+    {
+        // <слот>.<поколение>.journal
+        const FString GenerationString = FPaths::GetExtension(FPaths::GetBaseFilename(File));
+        if (GenerationString.IsNumeric())
+        {
+            Generations.Add(static_cast<uint32>(FCString::Strtoui64(*GenerationString, nullptr, 10)));
+        }
+    }
+    Generations.Sort();
+    return Generations;
+}
+
+bool UWSaveJournal::ReadJournalFile(const FString& Path, TArray<FJournalRecord>& OutRecords, int64& OutValidSize) const
+{
+    TArray<uint8> Bytes;
+    if (!FFileHelper::LoadFileToArray(Bytes, *Path, FILEREAD_Silent))
+    {
+        return false;
+    }
+
+    const int64 HeaderSize = sizeof(FJournalHeader);
+    FJournalHeader Header;
+    if (Bytes.Num() >= HeaderSize)
+    {
+        FMemory::Memcpy(&Header, Bytes.GetData(), HeaderSize);
+    }
+
+    if (Bytes.Num() < HeaderSize || Header.Magic != JournalMagic || Header.Version != JournalVersion)
+    {
+        // Файл создавался в момент сбоя: записей в нем нет
+        UE_LOG(LogTemp, Warning, TEXT("WSaveJournal: Discarding invalid journal %s"), *Path);
+        IFileManager::Get().Delete(*Path);
+        return false;
+    }
+
+    // Принимаем записи до первой неполной или с неверной контрольной суммой
+    const int32 MaxRecords = static_cast<int32>((Bytes.Num() - HeaderSize) / sizeof(FJournalRecord));
+    OutRecords.Reset(MaxRecords);
+    for (int32 Index = 0; Index < MaxRecords; ++Index)
+    {
+        FJournalRecord Record;
+        FMemory::Memcpy(&Record, Bytes.GetData() + HeaderSize + Index * sizeof(FJournalRecord), sizeof(FJournalRecord));
+        if (Record.Crc != ComputeCrc(Record))
+            break;
+        OutRecords.Add(Record);
+    }
+
+    OutValidSize = HeaderSize + OutRecords.Num() * static_cast<int64>(sizeof(FJournalRecord));
+    if (OutValidSize < Bytes.Num())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("WSaveJournal: Dropping %lld torn bytes at the end of %s"), Bytes.Num() - OutValidSize, *Path);
+        Bytes.SetNum(static_cast<int32>(OutValidSize));
+        UWSaveService::WriteFileAtomic(Path, Bytes);
+    }
+    return true;
+}
+
+void UWSaveJournal::DeleteJournalsBefore(uint32 InGeneration) const
+{
+    for (const uint32 FileGeneration : FindJournalGenerations())
+    {
+        if (FileGeneration < InGeneration)
+        {
+            IFileManager::Get().Delete(*GetJournalPath(FileGeneration));
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------
+// ЗАПИСЬ
+//----------------------------------------------------------------------------------------
+
+uint32 UWSaveJournal::ComputeCrc(const FJournalRecord& Record)
+{
+    return FCrc::MemCrc32(&Record, STRUCT_OFFSET(FJournalRecord, Crc));
+}
+
+void UWSaveJournal::ApplyRecord(UWTowerSaveGame* Save, const FJournalRecord& Record)
+{
+    switch (static_cast<EWJournalRecordType>(Record.Type))
+    {
+    case EWJournalRecordType::LevelUnlocked:
+        Save->UnlockLevel(Record.LevelId);
+        break;
+    case EWJournalRecordType::BestScore:
+        Save->SetBestScore(Record.LevelId, static_cast<int32>(Record.Value));
+        break;
+    case EWJournalRecordType::BestTime:
+        Save->SetBestCompletionTime(Record.LevelId, FMath::AsFloat(Record.Value));
+        break;
+    default:
+        UE_LOG(LogTemp, Warning, TEXT("WSaveJournal: Unknown record type %d"), Record.Type);
+        break;
+    }
+}
+
+void UWSaveJournal::AppendLevelUnlocked(int32 LevelId)
+{
+    Append(EWJournalRecordType::LevelUnlocked, LevelId, 0);
+}
+
+void UWSaveJournal::AppendBestScore(int32 LevelId, int32 Score)
+{
+    Append(EWJournalRecordType::BestScore, LevelId, static_cast<uint32>(Score));
+}
+
+void UWSaveJournal::AppendBestTime(int32 LevelId, float Time)
+{
+    Append(EWJournalRecordType::BestTime, LevelId, FMath::AsUInt(Time));
+}
+
+void UWSaveJournal::Append(EWJournalRecordType Type, int32 LevelId, uint32 Value)
+{
+    LLM_SCOPE_BYTAG(Tower_Save);
+    if (!SaveGame || LevelId < 0 || LevelId > MAX_uint16)
+        return;
+
+    FJournalRecord Record;
+    Record.Type = static_cast<uint8>(Type);
+    Record.Reserved = 0;
+    Record.LevelId = static_cast<uint16>(LevelId);
+    Record.Value = Value;
+    Record.Crc = ComputeCrc(Record);
+    PendingRecords.Add(Record);
+
+    INC_DWORD_STAT(STAT_TowerJournalRecords);
+
+    // Записи, пришедшие во время фоновой записи, уйдут следующей пачкой
+    if (!bFlushInFlight)
+    {
+        StartFlush();
+    }
+}
+
+void UWSaveJournal::StartFlush()
+{
+    bFlushInFlight = true;
+
+    const FString Path = GetJournalPath(Generation);
+    const uint32 TargetGeneration = Generation;
+    TSharedPtr<FWriterState, ESPMode::ThreadSafe> State = WriterState;
+    TWeakObjectPtr<UWSaveJournal> WeakThis(this);
+
+    PendingFlush = Async(EAsyncExecution::ThreadPool,
+        [WeakThis, State, Path, TargetGeneration, Records = MoveTemp(PendingRecords)]()
+        {
+            const double StartTime = FPlatformTime::Seconds();
+            int64 BytesWritten = 0;
+
+            // Файл нового поколения открывается при первой записи в него
+            if (!State->Writer || State->Generation != TargetGeneration)
+            {
+                State->Writer.Reset();
+
+                IFileManager& FileManager = IFileManager::Get();
+                const bool bNewFile = FileManager.FileSize(*Path) < static_cast<int64>(sizeof(FJournalHeader));
+                State->Writer.Reset(FileManager.CreateFileWriter(*Path, bNewFile ? 0 : FILEWRITE_Append));
+                State->Generation = TargetGeneration;
+
+                if (State->Writer && bNewFile)
+                {
+                    FJournalHeader Header = { JournalMagic, JournalVersion, TargetGeneration, 0 };
+                    State->Writer->Serialize(&Header, sizeof(Header));
+                    BytesWritten += sizeof(Header);
+                }
+            }
+
+            bool bSuccess = false;
+            if (State->Writer)
+            {
+                State->Writer->Serialize(const_cast<FJournalRecord*>(Records.GetData()), Records.Num() * sizeof(FJournalRecord));
+                State->Writer->Flush();
+                BytesWritten += Records.Num() * sizeof(FJournalRecord);
+                bSuccess = !State->Writer->IsError();
+            }
+
+            const double WriteSeconds = FPlatformTime::Seconds() - StartTime;
+            AsyncTask(ENamedThreads::GameThread, [WeakThis, BytesWritten, bSuccess, WriteSeconds]()
+            {
+                if (UWSaveJournal* Journal = WeakThis.Get())
+                {
+                    Journal->OnFlushFinished(BytesWritten, bSuccess, WriteSeconds);
+                }
+            });
+        });
+}
+
+void UWSaveJournal::OnFlushFinished(int64 BytesWritten, bool bSuccess, double WriteSeconds)
+{
+    if (!bFlushInFlight)
+    {
+        // Запись уже учтена в Close
+        return;
+    }
+
+    bFlushInFlight = false;
+    JournalBytes += BytesWritten;
+    SET_FLOAT_STAT(STAT_TowerJournalWriteTime, static_cast<float>(WriteSeconds * 1000.0));
+
+    if (!bSuccess)
+    {
+        // Журнал недоступен: сохраняем прогресс полным снимком
+        UE_LOG(LogTemp, Error, TEXT("WSaveJournal: Failed to append to %s, falling back to a full save"), *GetJournalPath(Generation));
+        SaveService->MarkDirty(SaveGame, SlotName);
+    }
+    else
+    {
+        OnJournalFlushed.Broadcast(SlotName, SaveGame);
+    }
+
+    if (JournalBytes >= CompactThresholdBytes && SnapshotWritesToWait == 0)
+    {
+        StartCompaction();
+    }
+
+    if (PendingRecords.Num() > 0)
+    {
+        StartFlush();
+    }
+}
+
+//----------------------------------------------------------------------------------------
+// УПЛОТНЕНИЕ
+//----------------------------------------------------------------------------------------
+
+void UWSaveJournal::StartCompaction()
+{
+    // Снимок делается сразу и содержит все записи текущего поколения,
+    // новые записи идут в журнал следующего поколения
+    ++Generation;
+    JournalBytes = 0;
+    SaveGame->SetJournalGeneration(static_cast<int32>(Generation));
+
+    // Запись слота, уже идущая в фоне, сделана до смены поколения - ждем и следующую
+    SnapshotWritesToWait = SaveService->IsWriteInFlight() ? 2 : 1;
+    SaveService->MarkDirty(SaveGame, SlotName);
+    SaveService->FlushNow();
+
+    INC_DWORD_STAT(STAT_TowerJournalCompactions);
+    UE_LOG(LogTemp, Log, TEXT("WSaveJournal: Compacting slot %s into generation %u"), *SlotName, Generation);
+}
+
+void UWSaveJournal::OnSnapshotWritten(const FString& WrittenSlot, bool bSuccess)
+{
+    if (WrittenSlot != SlotName || SnapshotWritesToWait == 0)
+        return;
+
+    if (!bSuccess)
+    {
+        // Старые журналы остаются и будут применены при загрузке
+        SnapshotWritesToWait = 0;
+        return;
+    }
+
+    if (--SnapshotWritesToWait == 0)
+    {
+        DeleteJournalsBefore(Generation);
+    }
+}
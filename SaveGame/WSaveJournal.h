@@ -0,0 +1,138 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "Async/Future.h"
+#include "WSaveJournal.generated.h"
+
+class UWSaveService;
+class UWTowerSaveGame;
+
+// Записи журнала дошли до диска (имя слота, сохранение с уже примененными изменениями)
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnWJournalFlushed, const FString& /*SlotName*/, UWTowerSaveGame* /*SaveGame*/);
+
+// Тип записи журнала сохранения
+enum class EWJournalRecordType : uint8
+{
+    LevelUnlocked = 1,
+    BestScore = 2,
+    BestTime = 3
+};
+
+/**
+ * Журнал изменений сохранения.
+ * Изменения прогресса дописываются в конец файла <слот>.<поколение>.journal записями
+ * по 12 байт с контрольной суммой, поэтому стоимость события не зависит от размера сохранения.
+ * Когда журнал превышает порог, начинается новое поколение, а полный снимок пишется
+ * в фоне через UWSaveService; старые журналы удаляются после записи снимка.
+ * При загрузке поверх снимка применяются журналы его поколения и новее,
+ * недописанная запись в конце файла отрезается.
+ */
+UCLASS()
+class WTOWER_API UWSaveJournal : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    UWSaveJournal();
+
+    // Инициализация (снимки пишет сервис сохранения)
+    void Initialize(UWSaveService* InSaveService);
+
+    // Открыть журнал слота: применить записи поверх загруженного снимка и продолжить запись.
+    // Возвращает количество примененных записей
+    int32 Open(const FString& InSlotName, UWTowerSaveGame* InSaveGame);
+
+    // Дописать ожидающие записи и закрыть файл
+    void Close();
+
+    // Записи изменений (данные в сохранении уже должны быть обновлены)
+    void AppendLevelUnlocked(int32 LevelId);
+    void AppendBestScore(int32 LevelId, int32 Score);
+    void AppendBestTime(int32 LevelId, float Time);
+
+    // Размер текущего журнала (байт)
+    int64 GetJournalSize() const { return JournalBytes; }
+
+    // Вызывается на игровом потоке после успешной дозаписи журнала и при закрытии с дозаписью
+    FOnWJournalFlushed OnJournalFlushed;
+
+    // Порог размера журнала, после которого он уплотняется в снимок (байт)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Сохранение")
+    int32 CompactThresholdBytes;
+
+private:
+    // Заголовок файла журнала
+    struct FJournalHeader
+    {
+        uint32 Magic;
+        uint32 Version;
+        uint32 Generation;
+        uint32 Reserved;
+    };
+
+    // Запись журнала; контрольная сумма считается по первым 8 байтам
+    struct FJournalRecord
+    {
+        uint8 Type;
+        uint8 Reserved;
+        uint16 LevelId;
+        uint32 Value;
+        uint32 Crc;
+    };
+    static_assert(sizeof(FJournalRecord) == 12, "FJournalRecord is stored on disk and must stay 12 bytes");
+
+    // Открытый файл журнала; используется только фоновыми задачами записи, по очереди
+    struct FWriterState
+    {
+        TUniquePtr<FArchive> Writer;
+        uint32 Generation = 0;
+    };
+
+    static constexpr uint32 JournalMagic = 0x4A535457; // "WTSJ"
+    static constexpr uint32 JournalVersion = 1;
+
+    UPROPERTY()
+    UWSaveService* SaveService;
+
+    UPROPERTY()
+    UWTowerSaveGame* SaveGame;
+
+    FString SlotName;
+
+    // Поколение текущего журнала и его размер
+    uint32 Generation;
+    int64 JournalBytes;
+
+    // Записи, ожидающие фоновой записи
+    TArray<FJournalRecord> PendingRecords;
+    bool bFlushInFlight;
+    TFuture<void> PendingFlush;
+    TSharedPtr<FWriterState, ESPMode::ThreadSafe> WriterState;
+
+    // Сколько записей слота нужно дождаться, прежде чем удалить старые журналы
+    int32 SnapshotWritesToWait;
+
+    void Append(EWJournalRecordType Type, int32 LevelId, uint32 Value);
+    void StartFlush();
+    void OnFlushFinished(int64 BytesWritten, bool bSuccess, double WriteSeconds);
+
+    // Начать новое поколение и записать полный снимок в фоне
+    void StartCompaction();
+
+    UFUNCTION()
+    void OnSnapshotWritten(const FString& WrittenSlot, bool bSuccess);
+
+    FString GetJournalPath(uint32 InGeneration) const;
+
+    // Поколения журналов слота на диске (по возрастанию)
+    TArray<uint32> FindJournalGenerations() const;
+
+    // Прочитать целые записи журнала, отрезав недописанный хвост
+    bool ReadJournalFile(const FString& Path, TArray<FJournalRecord>& OutRecords, int64& OutValidSize) const;
+
+    void DeleteJournalsBefore(uint32 InGeneration) const;
+
+    static uint32 ComputeCrc(const FJournalRecord& Record);
+    static void ApplyRecord(UWTowerSaveGame* Save, const FJournalRecord& Record);
+};
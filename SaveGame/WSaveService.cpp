@@ -0,0 +1,294 @@
+#include "WSaveService.h"
+#include "WTowerSaveGame.h"
+#include "../WTowerStats.h"
+#include "../WTowerMemory.h"
+#include "Kismet/GameplayStatics.h"
+#include "Async/Async.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+UWSaveService::UWSaveService()
+{
+    // Инициализация по умолчанию
+    CoalesceWindow = 0.5f;
+    DirtySave = nullptr;
+    bDirty = false;
+    DirtySince = 0.0;
+    bWriteInFlight = false;
+    WriteSerial = 0;
+    WriteRequestedAt = 0.0;
+    LastSaveLatencyMs = 0.0f;
+}
+
+void UWSaveService::Initialize()
+{
+    TickHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UWSaveService::Tick));
+
+    UE_LOG(LogTemp, Log, TEXT("WSaveService: Initialized"));
+}
+
+void UWSaveService::Shutdown()
+{
+    FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
+
+    // При завершении работы блокировка допустима: данные не должны потеряться
+    WaitForPendingWrites();
+    if (bDirty)
+    {
+        StartWrite();
+        WaitForPendingWrites();
+    }
+}
+
+//----------------------------------------------------------------------------------------
+// ЗАПИСЬ
+//----------------------------------------------------------------------------------------
+
+void UWSaveService::MarkDirty(UWTowerSaveGame* SaveGame, const FString& SlotName)
+{
+    if (!SaveGame)
+        return;
+
+    // Смена слота: сначала снимаем предыдущий, во время записи он встанет в очередь
+    if (bDirty && DirtySlot != SlotName)
+    {
+        StartWrite();
+    }
+
+    if (bDirty)
+    {
+        INC_DWORD_STAT(STAT_TowerSavesCoalesced);
+    }
+    else
+    {
+        DirtySince = FPlatformTime::Seconds();
+    }
+
+    bDirty = true;
+    DirtySave = SaveGame;
+    DirtySlot = SlotName;
+}
+
+void UWSaveService::FlushNow()
+{
+    if (bDirty)
+    {
+        StartWrite();
+    }
+}
+
+bool UWSaveService::Tick(float DeltaTime)
+{
+    if (bDirty && !bWriteInFlight && FPlatformTime::Seconds() - DirtySince >= CoalesceWindow)
+    {
+        StartWrite();
+    }
+    return true;
+}
+
+void UWSaveService::StartWrite()
+{
+    LLM_SCOPE_BYTAG(Tower_Save);
+    UWTowerSaveGame* SaveGame = DirtySave;
+    DirtySave = nullptr;
+    bDirty = false;
+    if (!SaveGame)
+        return;
+
+    // Снимок объекта в память делается на игровом потоке: сериализация UObject
+    // небезопасна вне его, но занимает микросекунды в отличие от записи на диск
+    TArray<uint8> Payload;
+    if (!UGameplayStatics::SaveGameToMemory(SaveGame, Payload))
+    {
+        UE_LOG(LogTemp, Error, TEXT("WSaveService: Failed to serialize slot %s"), *DirtySlot);
+        OnSaveCompleted.Broadcast(DirtySlot, false);
+        return;
+    }
+
+    FQueuedWrite Write;
+    Write.SlotName = DirtySlot;
+    Write.Payload = MoveTemp(Payload);
+    Write.RequestedAt = DirtySince;
+
+    if (!bWriteInFlight)
+    {
+        LaunchWrite(MoveTemp(Write));
+        return;
+    }
+
+    // Снимок уже сделан, поэтому изменения не потеряются; более новый снимок слота
+    // заменяет ожидающий, сохраняя время первой пометки
+    if (FQueuedWrite* Queued = QueuedWrites.FindByPredicate([&Write](const FQueuedWrite& Other) { return Other.SlotName == Write.SlotName; }))
+    {
+        Queued->Payload = MoveTemp(Write.Payload);
+        INC_DWORD_STAT(STAT_TowerSavesCoalesced);
+    }
+    else
+    {
+        QueuedWrites.Add(MoveTemp(Write));
+    }
+}
+
+void UWSaveService::LaunchWrite(FQueuedWrite&& Write)
+{
+    bWriteInFlight = true;
+    WriteRequestedAt = Write.RequestedAt;
+
+    const uint32 Serial = ++WriteSerial;
+    const FString SlotName = Write.SlotName;
+    const FString FilePath = GetSlotFilePath(SlotName);
+    TWeakObjectPtr<UWSaveService> WeakThis(this);
+
+    PendingWrite = Async(EAsyncExecution::ThreadPool, [WeakThis, Serial, SlotName, FilePath, Payload = MoveTemp(Write.Payload)]()
+    {
+        const double StartTime = FPlatformTime::Seconds();
+
+        FSaveFileHeader Header;
+        Header.Magic = SaveFileMagic;
+        Header.Version = SaveFileVersion;
+        Header.PayloadSize = Payload.Num();
+        Header.Checksum = FCrc::MemCrc32(Payload.GetData(), Payload.Num());
+
+        TArray<uint8> FileData;
+        FileData.Reserve(sizeof(Header) + Payload.Num());
+        FileData.Append(reinterpret_cast<const uint8*>(&Header), sizeof(Header));
+        FileData.Append(Payload);
+
+        const bool bSuccess = WriteFileAtomic(FilePath, FileData);
+        const double WriteSeconds = FPlatformTime::Seconds() - StartTime;
+
+        AsyncTask(ENamedThreads::GameThread, [WeakThis, Serial, SlotName, bSuccess, WriteSeconds]()
+        {
+            if (UWSaveService* Service = WeakThis.Get())
+            {
+                Service->OnWriteFinished(Serial, SlotName, bSuccess, WriteSeconds);
+            }
+        });
+    });
+}
+
+void UWSaveService::OnWriteFinished(uint32 Serial, const FString& SlotName, bool bSuccess, double WriteSeconds)
+{
+    if (!bWriteInFlight || Serial != WriteSerial)
+    {
+        // Запись уже учтена в WaitForPendingWrites
+        return;
+    }
+
+    bWriteInFlight = false;
+    LastSaveLatencyMs = static_cast<float>((FPlatformTime::Seconds() - WriteRequestedAt) * 1000.0);
+
+    SET_FLOAT_STAT(STAT_TowerSaveLatency, LastSaveLatencyMs);
+    SET_FLOAT_STAT(STAT_TowerSaveWriteTime, static_cast<float>(WriteSeconds * 1000.0));
+    INC_DWORD_STAT(STAT_TowerSavesWritten);
+
+    UE_LOG(LogTemp, Log, TEXT("WSaveService: Slot %s written (%s), latency %.1f ms, disk %.1f ms"),
+        *SlotName, bSuccess ? TEXT("ok") : TEXT("failed"), LastSaveLatencyMs, WriteSeconds * 1000.0);
+
+    // Следующий снимок из очереди уходит на запись до оповещения, чтобы подписчики видели актуальное IsWriteInFlight
+    if (QueuedWrites.Num() > 0)
+    {
+        FQueuedWrite Next = MoveTemp(QueuedWrites[0]);
+        QueuedWrites.RemoveAt(0);
+        LaunchWrite(MoveTemp(Next));
+    }
+
+    OnSaveCompleted.Broadcast(SlotName, bSuccess);
+}
+
+void UWSaveService::WaitForPendingWrites()
+{
+    while (bWriteInFlight)
+    {
+        if (PendingWrite.IsValid())
+        {
+            PendingWrite.Wait();
+        }
+        bWriteInFlight = false;
+
+        if (QueuedWrites.Num() > 0)
+        {
+            FQueuedWrite Next = MoveTemp(QueuedWrites[0]);
+            QueuedWrites.RemoveAt(0);
+            LaunchWrite(MoveTemp(Next));
+        }
+    }
+}
+
+bool UWSaveService::WriteFileAtomic(const FString& FilePath, const TArray<uint8>& Data)
+{
+    const FString TempPath = FilePath + TEXT(".tmp");
+
+    if (!FFileHelper::SaveArrayToFile(Data, *TempPath))
+    {
+        return false;
+    }
+
+    // Переименование заменяет старый файл целиком, недописанный файл никогда не станет слотом
+    return IFileManager::Get().Move(*FilePath, *TempPath, true, true);
+}
+
+//----------------------------------------------------------------------------------------
+// ЗАГРУЗКА
+//----------------------------------------------------------------------------------------
+
+FString UWSaveService::GetSlotFilePath(const FString& SlotName)
+{
+    return FPaths::ProjectSavedDir() / TEXT("SaveGames") / (SlotName + TEXT(".sav"));
+}
+
+bool UWSaveService::DoesSlotExist(const FString& SlotName) const
+{
+    return IFileManager::Get().FileExists(*GetSlotFilePath(SlotName));
+}
+
+UWTowerSaveGame* UWSaveService::LoadSlot(const FString& SlotName) const
+{
+    TArray<uint8> Payload;
+    if (!ReadSlotPayload(SlotName, Payload))
+    {
+        return nullptr;
+    }
+    return LoadSlotFromPayload(Payload);
+}
+
+UWTowerSaveGame* UWSaveService::LoadSlotFromPayload(const TArray<uint8>& Payload)
+{
+    LLM_SCOPE_BYTAG(Tower_Save);
+    return Cast<UWTowerSaveGame>(UGameplayStatics::LoadGameFromMemory(Payload));
+}
+
+bool UWSaveService::ReadSlotPayload(const FString& SlotName, TArray<uint8>& OutPayload)
+{
+    TArray<uint8> FileData;
+    if (!FFileHelper::LoadFileToArray(FileData, *GetSlotFilePath(SlotName)))
+    {
+        return false;
+    }
+
+    const int32 HeaderSize = sizeof(FSaveFileHeader);
+    FSaveFileHeader Header;
+    if (FileData.Num() >= HeaderSize)
+    {
+        FMemory::Memcpy(&Header, FileData.GetData(), HeaderSize);
+    }
+
+    if (FileData.Num() < HeaderSize || Header.Magic != SaveFileMagic)
+    {
+        // Старый формат UGameplayStatics::SaveGameToSlot без заголовка
+        OutPayload = MoveTemp(FileData);
+        return true;
+    }
+
+    const uint8* PayloadData = FileData.GetData() + HeaderSize;
+    if (static_cast<uint32>(FileData.Num() - HeaderSize) < Header.PayloadSize
+        || FCrc::MemCrc32(PayloadData, Header.PayloadSize) != Header.Checksum)
+    {
+        UE_LOG(LogTemp, Error, TEXT("WSaveService: Checksum mismatch in slot %s"), *SlotName);
+        return false;
+    }
+
+    OutPayload = TArray<uint8>(PayloadData, Header.PayloadSize);
+    return true;
+}
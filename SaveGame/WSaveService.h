@@ -0,0 +1,128 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "Containers/Ticker.h"
+#include "Async/Future.h"
+#include "WSaveService.generated.h"
+
+class UWTowerSaveGame;
+
+// Завершение записи сохранения (имя слота, успех)
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnWSaveCompleted, const FString&, SlotName, bool, bSuccess);
+
+/**
+ * Сервис асинхронного сохранения.
+ * Изменения помечают сохранение как грязное, записи в пределах окна объединяются в одну.
+ * Снимок объекта делается на игровом потоке в память, контрольная сумма и запись
+ * на диск (временный файл + переименование) выполняются на рабочем потоке.
+ * Снимки, сделанные во время фоновой записи, ждут в очереди и пишутся по порядку.
+ */
+UCLASS()
+class WTOWER_API UWSaveService : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    UWSaveService();
+
+    // Инициализация и завершение работы (при завершении ожидающие записи сбрасываются на диск)
+    void Initialize();
+    void Shutdown();
+
+    // Пометить сохранение как измененное, запись будет выполнена после окна объединения
+    UFUNCTION(BlueprintCallable, Category = "Сохранение")
+    void MarkDirty(UWTowerSaveGame* SaveGame, const FString& SlotName);
+
+    // Начать запись немедленно, не дожидаясь окончания окна (во время фоновой записи - встать в очередь за ней)
+    UFUNCTION(BlueprintCallable, Category = "Сохранение")
+    void FlushNow();
+
+    // Дождаться окончания всех записей, включая очередь (только для завершения работы)
+    void WaitForPendingWrites();
+
+    // Загрузить слот с проверкой контрольной суммы (поддерживает старый формат без заголовка)
+    UWTowerSaveGame* LoadSlot(const FString& SlotName) const;
+
+    // Прочитать файл слота и проверить контрольную сумму, не создавая объект (можно вызывать с любого потока)
+    static bool ReadSlotPayload(const FString& SlotName, TArray<uint8>& OutPayload);
+
+    // Создать объект сохранения из прочитанных данных (только игровой поток)
+    static UWTowerSaveGame* LoadSlotFromPayload(const TArray<uint8>& Payload);
+
+    // Идет ли сейчас фоновая запись
+    bool IsWriteInFlight() const { return bWriteInFlight; }
+
+    // Существует ли файл слота
+    bool DoesSlotExist(const FString& SlotName) const;
+
+    // Путь к файлу слота
+    static FString GetSlotFilePath(const FString& SlotName);
+
+    // Записать данные атомарно: во временный файл и затем переименовать (рабочий поток)
+    static bool WriteFileAtomic(const FString& FilePath, const TArray<uint8>& Data);
+
+    // Задержка последнего сохранения: от первой пометки до записи на диск
+    UFUNCTION(BlueprintCallable, Category = "Сохранение")
+    float GetLastSaveLatencyMs() const { return LastSaveLatencyMs; }
+
+    // Окно объединения записей (секунды)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Сохранение")
+    float CoalesceWindow;
+
+    // Вызывается на игровом потоке после завершения записи
+    UPROPERTY(BlueprintAssignable, Category = "Сохранение")
+    FOnWSaveCompleted OnSaveCompleted;
+
+private:
+    // Заголовок файла сохранения
+    struct FSaveFileHeader
+    {
+        uint32 Magic;
+        uint32 Version;
+        uint32 PayloadSize;
+        uint32 Checksum;
+    };
+
+    static constexpr uint32 SaveFileMagic = 0x56535457; // "WTSV"
+    static constexpr uint32 SaveFileVersion = 1;
+
+    // Снимок слота, готовый к записи на диск
+    struct FQueuedWrite
+    {
+        FString SlotName;
+        TArray<uint8> Payload;
+        double RequestedAt;
+    };
+
+    bool Tick(float DeltaTime);
+
+    // Снять снимок грязного сохранения и записать его сразу или поставить в очередь
+    void StartWrite();
+
+    // Отправить снимок на запись в фоне
+    void LaunchWrite(FQueuedWrite&& Write);
+
+    void OnWriteFinished(uint32 Serial, const FString& SlotName, bool bSuccess, double WriteSeconds);
+
+    FTSTicker::FDelegateHandle TickHandle;
+
+    // Сохранение, ожидающее записи; сильная ссылка, чтобы объект дожил до снимка,
+    // даже если GameInstance уже переключился на другой профиль
+    UPROPERTY()
+    UWTowerSaveGame* DirtySave;
+    FString DirtySlot;
+    bool bDirty;
+    double DirtySince;
+
+    // Снимки, ожидающие окончания текущей записи (не больше одного на слот)
+    TArray<FQueuedWrite> QueuedWrites;
+
+    // Текущая фоновая запись; номер отсекает завершения записей, уже учтенных в WaitForPendingWrites
+    bool bWriteInFlight;
+    uint32 WriteSerial;
+    double WriteRequestedAt;
+    TFuture<void> PendingWrite;
+
+    float LastSaveLatencyMs;
+};
@@ -1,101 +1,127 @@
 #include "WTowerSaveGame.h"
+#include "../Levels/WLevelRegistry.h"
 
 UWTowerSaveGame::UWTowerSaveGame()
 {
     // Инициализация по умолчанию
     UserName = TEXT("Player");
     SaveDate = FDateTime::Now();
-    
-    // Разблокируем первый уровень по умолчанию
-    FLevelData FirstLevelData;
-    FirstLevelData.bUnlocked = true;
-    LevelProgress.Add(TEXT("Level_1"), FirstLevelData);
+
+    // Старые сохранения не содержат версии и загружаются как версия 1.
+    // Первый уровень разблокирует GameInstance по реестру уровней
+    SaveVersion = 1;
+    JournalGeneration = 0;
 }
 
-float UWTowerSaveGame::GetBestCompletionTime(const FString& LevelName) const
+FLevelData& UWTowerSaveGame::GetOrAddLevelData(int32 LevelId)
 {
-    // Получаем лучшее время прохождения для указанного уровня
-    if (LevelProgress.Contains(LevelName))
+    check(LevelId >= 0);
+
+    // Создаем записи до нужного идентификатора, если их нет
+    if (!LevelProgressById.IsValidIndex(LevelId))
     {
-        return LevelProgress[LevelName].BestCompletionTime;
+        LevelProgressById.SetNum(LevelId + 1);
     }
-    return 0.0f;
+    return LevelProgressById[LevelId];
 }
 
-void UWTowerSaveGame::SetBestCompletionTime(const FString& LevelName, float Time)
+float UWTowerSaveGame::GetBestCompletionTime(int32 LevelId) const
+{
+    // Получаем лучшее время прохождения для указанного уровня
+    return LevelProgressById.IsValidIndex(LevelId) ? LevelProgressById[LevelId].BestCompletionTime : 0.0f;
+}
+
+void UWTowerSaveGame::SetBestCompletionTime(int32 LevelId, float Time)
 {
-    // Создаем запись для уровня, если ее нет
-    if (!LevelProgress.Contains(LevelName))
-    {
-        FLevelData NewLevelData;
-        LevelProgress.Add(LevelName, NewLevelData);
-    }
-    
     // Обновляем лучшее время
-    FLevelData& LevelData = LevelProgress[LevelName];
-    LevelData.BestCompletionTime = Time;
+    GetOrAddLevelData(LevelId).BestCompletionTime = Time;
 }
 
-int32 UWTowerSaveGame::GetBestScore(const FString& LevelName) const
+int32 UWTowerSaveGame::GetBestScore(int32 LevelId) const
 {
     // Получаем лучший счет для указанного уровня
-    if (LevelProgress.Contains(LevelName))
-    {
-        return LevelProgress[LevelName].BestScore;
-    }
-    return 0;
+    return LevelProgressById.IsValidIndex(LevelId) ? LevelProgressById[LevelId].BestScore : 0;
 }
 
-void UWTowerSaveGame::SetBestScore(const FString& LevelName, int32 Score)
+void UWTowerSaveGame::SetBestScore(int32 LevelId, int32 Score)
 {
-    // Создаем запись для уровня, если ее нет
-    if (!LevelProgress.Contains(LevelName))
-    {
-        FLevelData NewLevelData;
-        LevelProgress.Add(LevelName, NewLevelData);
-    }
-    
     // Обновляем лучший счет
-    FLevelData& LevelData = LevelProgress[LevelName];
-    LevelData.BestScore = Score;
+    GetOrAddLevelData(LevelId).BestScore = Score;
 }
 
-void UWTowerSaveGame::UnlockLevel(const FString& LevelName)
+void UWTowerSaveGame::UnlockLevel(int32 LevelId)
 {
-    // Создаем запись для уровня, если ее нет
-    if (!LevelProgress.Contains(LevelName))
-    {
-        FLevelData NewLevelData;
-        LevelProgress.Add(LevelName, NewLevelData);
-    }
-    
     // Разблокируем уровень
-    FLevelData& LevelData = LevelProgress[LevelName];
-    LevelData.bUnlocked = true;
+    GetOrAddLevelData(LevelId).bUnlocked = true;
 }
 
-bool UWTowerSaveGame::IsLevelUnlocked(const FString& LevelName) const
+bool UWTowerSaveGame::IsLevelUnlocked(int32 LevelId) const
 {
     // Проверяем, разблокирован ли указанный уровень
-    if (LevelProgress.Contains(LevelName))
-    {
-        return LevelProgress[LevelName].bUnlocked;
-    }
-    return false;
+    return LevelProgressById.IsValidIndex(LevelId) && LevelProgressById[LevelId].bUnlocked;
 }
 
-TArray<FString> UWTowerSaveGame::GetUnlockedLevels() const
+TArray<int32> UWTowerSaveGame::GetUnlockedLevels() const
 {
     // Возвращаем список разблокированных уровней
-    TArray<FString> UnlockedLevels;
+    TArray<int32> UnlockedLevels;
     
-    for (const auto& Pair : LevelProgress)
+    for (int32 LevelId = 0; LevelId < LevelProgressById.Num(); ++LevelId)
     {
-        if (Pair.Value.bUnlocked)
+        if (LevelProgressById[LevelId].bUnlocked)
         {
-            UnlockedLevels.Add(Pair.Key);
+            UnlockedLevels.Add(LevelId);
         }
     }
     
     return UnlockedLevels;
-}
\ No newline at end of file
+}
+
+int32 UWTowerSaveGame::GetCompletedLevelCount() const
+{
+    int32 Count = 0;
+    for (const FLevelData& Data : LevelProgressById)
+    {
+        if (Data.BestCompletionTime > 0.0f)
+        {
+            ++Count;
+        }
+    }
+    return Count;
+}
+
+int32 UWTowerSaveGame::GetTotalBestScore() const
+{
+    int32 Total = 0;
+    for (const FLevelData& Data : LevelProgressById)
+    {
+        Total += Data.BestScore;
+    }
+    return Total;
+}
+
+bool UWTowerSaveGame::MigrateLegacyProgress(const UWLevelRegistry* Registry)
+{
+    if (SaveVersion >= CurrentSaveVersion || !Registry)
+    {
+        return false;
+    }
+
+    // Версия 1: прогресс хранился по имени карты
+    for (const TPair<FString, FLevelData>& Pair : LevelProgress)
+    {
+        const int32 LevelId = Registry->FindLevelId(FName(*Pair.Key));
+        if (LevelId == INDEX_NONE)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("WTowerSaveGame: Dropping progress for unknown level %s"), *Pair.Key);
+            continue;
+        }
+        GetOrAddLevelData(LevelId) = Pair.Value;
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("WTowerSaveGame: Migrated %d levels from version %d"), LevelProgress.Num(), SaveVersion);
+
+    LevelProgress.Empty();
+    SaveVersion = CurrentSaveVersion;
+    return true;
+}
@@ -4,6 +4,8 @@
 #include "GameFramework/SaveGame.h"
 #include "WTowerSaveGame.generated.h"
 
+class UWLevelRegistry;
+
 /**
  * Структура для хранения данных об уровне
  */
@@ -42,36 +44,87 @@ class WTOWER_API UWTowerSaveGame : public USaveGame
 
 public:
     UWTowerSaveGame();
+
+    // Текущая версия формата сохранения
+    static constexpr int32 CurrentSaveVersion = 2;
     
     // Получить лучшее время прохождения для уровня
     UFUNCTION(BlueprintCallable, Category = "Сохранение")
-    float GetBestCompletionTime(const FString& LevelName) const;
+    float GetBestCompletionTime(int32 LevelId) const;
     
     // Установить лучшее время прохождения для уровня
     UFUNCTION(BlueprintCallable, Category = "Сохранение")
-    void SetBestCompletionTime(const FString& LevelName, float Time);
+    void SetBestCompletionTime(int32 LevelId, float Time);
     
     // Получить лучший счет для уровня
     UFUNCTION(BlueprintCallable, Category = "Сохранение")
-    int32 GetBestScore(const FString& LevelName) const;
+    int32 GetBestScore(int32 LevelId) const;
     
     // Установить лучший счет для уровня
     UFUNCTION(BlueprintCallable, Category = "Сохранение")
-    void SetBestScore(const FString& LevelName, int32 Score);
+    void SetBestScore(int32 LevelId, int32 Score);
     
     // Разблокировать уровень
     UFUNCTION(BlueprintCallable, Category = "Сохранение")
-    void UnlockLevel(const FString& LevelName);
+    void UnlockLevel(int32 LevelId);
     
     // Проверить, разблокирован ли уровень
     UFUNCTION(BlueprintCallable, Category = "Сохранение")
-    bool IsLevelUnlocked(const FString& LevelName) const;
+    bool IsLevelUnlocked(int32 LevelId) const;
     
-    // Получить все разблокированные уровни
+    // Получить идентификаторы всех разблокированных уровней
     UFUNCTION(BlueprintCallable, Category = "Сохранение")
-    TArray<FString> GetUnlockedLevels() const;
+    TArray<int32> GetUnlockedLevels() const;
+
+    //----------------------------------------------------------------------------------------
+    // ДАННЫЕ ПРОФИЛЯ
+    //----------------------------------------------------------------------------------------
+
+    // Имя пользователя
+    UFUNCTION(BlueprintCallable, Category = "Сохранение|Профиль")
+    FString GetUserName() const { return UserName; }
+
+    UFUNCTION(BlueprintCallable, Category = "Сохранение|Профиль")
+    void SetUserName(const FString& InUserName) { UserName = InUserName; }
+
+    // Дата последнего сохранения
+    UFUNCTION(BlueprintCallable, Category = "Сохранение|Профиль")
+    FDateTime GetSaveDate() const { return SaveDate; }
+
+    // Обновить дату сохранения до текущей
+    void TouchSaveDate() { SaveDate = FDateTime::Now(); }
+
+    // Миниатюра профиля
+    UFUNCTION(BlueprintCallable, Category = "Сохранение|Профиль")
+    FSoftObjectPath GetThumbnail() const { return Thumbnail; }
+
+    UFUNCTION(BlueprintCallable, Category = "Сохранение|Профиль")
+    void SetThumbnail(const FSoftObjectPath& InThumbnail) { Thumbnail = InThumbnail; }
+
+    // Количество пройденных уровней (есть лучшее время)
+    UFUNCTION(BlueprintCallable, Category = "Сохранение|Профиль")
+    int32 GetCompletedLevelCount() const;
+
+    // Сумма лучших счетов по всем уровням
+    UFUNCTION(BlueprintCallable, Category = "Сохранение|Профиль")
+    int32 GetTotalBestScore() const;
+
+    // Поколение журнала изменений, с которого применяются записи поверх этого снимка
+    int32 GetJournalGeneration() const { return JournalGeneration; }
+    void SetJournalGeneration(int32 InGeneration) { JournalGeneration = InGeneration; }
+
+    // Перенести прогресс из строкового формата версии 1 в плотный массив.
+    // Возвращает true, если сохранение было изменено
+    bool MigrateLegacyProgress(const UWLevelRegistry* Registry);
 
 private:
+    // Данные уровня с созданием записи при необходимости
+    FLevelData& GetOrAddLevelData(int32 LevelId);
+
+    // Версия формата сохранения (1 - строковые ключи LevelProgress)
+    UPROPERTY()
+    int32 SaveVersion;
+
     // Имя пользователя для сохранения
     UPROPERTY(VisibleAnywhere, Category = "SaveGame")
     FString UserName;
@@ -79,8 +132,20 @@ private:
     // Дата сохранения
     UPROPERTY(VisibleAnywhere, Category = "SaveGame")
     FDateTime SaveDate;
+
+    // Миниатюра профиля
+    UPROPERTY(VisibleAnywhere, Category = "SaveGame")
+    FSoftObjectPath Thumbnail;
+
+    // Поколение журнала изменений (см. UWSaveJournal)
+    UPROPERTY()
+    int32 JournalGeneration;
     
-    // Данные о прогрессе в уровнях
+    // Данные о прогрессе в уровнях, индекс = идентификатор уровня из UWLevelRegistry
     UPROPERTY(VisibleAnywhere, Category = "SaveGame")
+    TArray<FLevelData> LevelProgressById;
+
+    // Прогресс в формате версии 1, читается только для миграции
+    UPROPERTY()
     TMap<FString, FLevelData> LevelProgress;
 };
\ No newline at end of file
@@ -0,0 +1,248 @@
+#include "WStartupTaskGraph.h"
+#include "Async/Async.h"
+#include "HAL/PlatformProcess.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+FWStartupTaskGraph::FWStartupTaskGraph()
+{
+    WorkerDoneEvent = FPlatformProcess::GetSynchEventFromPool(false);
+    GraphStartTime = 0.0;
+    TotalTimeMs = 0.0f;
+}
+
+FWStartupTaskGraph::~FWStartupTaskGraph()
+{
+    FPlatformProcess::ReturnSynchEventToPool(WorkerDoneEvent);
+}
+
+void FWStartupTaskGraph::AddTask(FName Name, EWStartupThread Thread, TArray<FName> Dependencies, TFunction<void()> Work)
+{
+    FTask& Task = Tasks.AddDefaulted_GetRef();
+    Task.Name = Name;
+    Task.Thread = Thread;
+    Task.DependencyNames = MoveTemp(Dependencies);
+    Task.Work = MoveTemp(Work);
+}
+
+//----------------------------------------------------------------------------------------
+// ВЫПОЛНЕНИЕ
+//----------------------------------------------------------------------------------------
+
+bool FWStartupTaskGraph::Run()
+{
+    check(IsInGameThread());
+    TRACE_CPUPROFILER_EVENT_SCOPE(FWStartupTaskGraph::Run);
+
+    if (!ResolveDependencies())
+    {
+        return false;
+    }
+
+    GraphStartTime = FPlatformTime::Seconds();
+    int32 NumDone = 0;
+    int32 NumWorkersRunning = 0;
+
+    while (NumDone < Tasks.Num())
+    {
+        // Забираем завершенные рабочие задачи
+        int32 FinishedIndex;
+        while (CompletedWorkerTasks.Dequeue(FinishedIndex))
+        {
+            Tasks[FinishedIndex].State = ETaskState::Done;
+            --NumWorkersRunning;
+            ++NumDone;
+        }
+
+        // Сначала запускаем все готовые рабочие задачи, чтобы они шли параллельно с игровым потоком
+        for (int32 Index = 0; Index < Tasks.Num(); ++Index)
+        {
+            FTask& Task = Tasks[Index];
+            if (Task.State == ETaskState::Pending && Task.Thread == EWStartupThread::Worker && AreDependenciesDone(Task))
+            {
+                Task.State = ETaskState::Running;
+                ++NumWorkersRunning;
+                LaunchWorkerTask(Index);
+            }
+        }
+
+        // Затем выполняем одну готовую задачу игрового потока и возвращаемся к проверке
+        bool bRanGameThreadTask = false;
+        for (int32 Index = 0; Index < Tasks.Num(); ++Index)
+        {
+            FTask& Task = Tasks[Index];
+            if (Task.State == ETaskState::Pending && Task.Thread == EWStartupThread::GameThread && AreDependenciesDone(Task))
+            {
+                Task.State = ETaskState::Running;
+                ExecuteTask(Index);
+                Task.State = ETaskState::Done;
+                ++NumDone;
+                bRanGameThreadTask = true;
+                break;
+            }
+        }
+
+        if (bRanGameThreadTask || NumDone == Tasks.Num())
+        {
+            continue;
+        }
+
+        if (NumWorkersRunning == 0 && CompletedWorkerTasks.IsEmpty())
+        {
+            // Ничего не выполняется и ничего не готово: в графе цикл
+            for (const FTask& Task : Tasks)
+            {
+                if (Task.State == ETaskState::Pending)
+                {
+                    UE_LOG(LogTemp, Error, TEXT("WStartupTaskGraph: Task %s can never run (dependency cycle)"), *Task.Name.ToString());
+                }
+            }
+            return false;
+        }
+
+        // Игровому потоку делать нечего, ждем окончания рабочей задачи
+        WorkerDoneEvent->Wait();
+    }
+
+    TotalTimeMs = static_cast<float>((FPlatformTime::Seconds() - GraphStartTime) * 1000.0);
+    return true;
+}
+
+bool FWStartupTaskGraph::ResolveDependencies()
+{
+    TMap<FName, int32> IndexByName;
+    for (int32 Index = 0; Index < Tasks.Num(); ++Index)
+    {
+        IndexByName.Add(Tasks[Index].Name, Index);
+    }
+
+    for (FTask& Task : Tasks)
+    {
+        Task.Dependencies.Reset();
+        for (const FName& DependencyName : Task.DependencyNames)
+        {
+            const int32* DependencyIndex = IndexByName.Find(DependencyName);
+            if (!DependencyIndex)
+            {
+                UE_LOG(LogTemp, Error, TEXT("WStartupTaskGraph: Task %s depends on unknown task %s"),
+                    *Task.Name.ToString(), *DependencyName.ToString());
+                return false;
+            }
+            Task.Dependencies.Add(*DependencyIndex);
+        }
+    }
+    return true;
+}
+
+bool FWStartupTaskGraph::AreDependenciesDone(const FTask& Task) const
+{
+    for (int32 DependencyIndex : Task.Dependencies)
+    {
+        if (Tasks[DependencyIndex].State != ETaskState::Done)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void FWStartupTaskGraph::ExecuteTask(int32 TaskIndex)
+{
+    FTask& Task = Tasks[TaskIndex];
+    TRACE_CPUPROFILER_EVENT_SCOPE_TEXT(*Task.Name.ToString());
+
+    Task.StartTime = FPlatformTime::Seconds() - GraphStartTime;
+    Task.Work();
+    Task.EndTime = FPlatformTime::Seconds() - GraphStartTime;
+}
+
+void FWStartupTaskGraph::LaunchWorkerTask(int32 TaskIndex)
+{
+    // Граф живет до конца Run, а Run не возвращается, пока рабочие задачи не завершены
+    Async(EAsyncExecution::ThreadPool, [this, TaskIndex]()
+        {
+            ExecuteTask(TaskIndex);
+            CompletedWorkerTasks.Enqueue(TaskIndex);
+            WorkerDoneEvent->Trigger();
+        });
+}
+
+//----------------------------------------------------------------------------------------
+// ОТЧЕТ
+//----------------------------------------------------------------------------------------
+
+TArray<FName> FWStartupTaskGraph::GetCriticalPath(float* OutLengthMs) const
+{
+    TArray<FName> Path;
+    if (Tasks.Num() == 0)
+    {
+        if (OutLengthMs)
+        {
+            *OutLengthMs = 0.0f;
+        }
+        return Path;
+    }
+
+    // Начинаем с задачи, завершившейся последней, и идем по зависимости, завершившейся позже остальных
+    int32 Current = 0;
+    for (int32 Index = 1; Index < Tasks.Num(); ++Index)
+    {
+        if (Tasks[Index].EndTime > Tasks[Current].EndTime)
+        {
+            Current = Index;
+        }
+    }
+
+    const double PathEnd = Tasks[Current].EndTime;
+    double PathStart = Tasks[Current].StartTime;
+
+    while (Current != INDEX_NONE)
+    {
+        Path.Insert(Tasks[Current].Name, 0);
+        PathStart = Tasks[Current].StartTime;
+
+        int32 Latest = INDEX_NONE;
+        for (int32 DependencyIndex : Tasks[Current].Dependencies)
+        {
+            if (Latest == INDEX_NONE || Tasks[DependencyIndex].EndTime > Tasks[Latest].EndTime)
+            {
+                Latest = DependencyIndex;
+            }
+        }
+        Current = Latest;
+    }
+
+    if (OutLengthMs)
+    {
+        *OutLengthMs = static_cast<float>((PathEnd - PathStart) * 1000.0);
+    }
+    return Path;
+}
+
+void FWStartupTaskGraph::LogReport() const
+{
+    UE_LOG(LogTemp, Log, TEXT("WStartupTaskGraph: Startup finished in %.2f ms (%d tasks)"), TotalTimeMs, Tasks.Num());
+
+    for (const FTask& Task : Tasks)
+    {
+        UE_LOG(LogTemp, Log, TEXT("WStartupTaskGraph:   %-24s %-6s start %7.2f ms  duration %7.2f ms"),
+            *Task.Name.ToString(),
+            Task.Thread == EWStartupThread::Worker ? TEXT("worker") : TEXT("game"),
+            Task.StartTime * 1000.0,
+            (Task.EndTime - Task.StartTime) * 1000.0);
+    }
+
+    float CriticalPathMs = 0.0f;
+    const TArray<FName> CriticalPath = GetCriticalPath(&CriticalPathMs);
+
+    FString PathString;
+    for (const FName& Name : CriticalPath)
+    {
+        if (!PathString.IsEmpty())
+        {
+            PathString += TEXT(" -> ");
+        }
+        PathString += Name.ToString();
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("WStartupTaskGraph: Critical path (%.2f ms): %s"), CriticalPathMs, *PathString);
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Event.h"
+#include "Containers/Queue.h"
+
+// Поток, на котором выполняется задача запуска
+enum class EWStartupThread : uint8
+{
+    GameThread,
+    Worker
+};
+
+/**
+ * Граф задач запуска игры.
+ * Задачи объявляются с зависимостями; задачи ввода-вывода выполняются параллельно
+ * в пуле потоков, задачи с UObject - на игровом потоке по мере готовности зависимостей.
+ * Каждая задача оборачивается в именованную область профилировщика, после выполнения
+ * строится отчет со временем задач и критическим путем.
+ */
+class WTOWER_API FWStartupTaskGraph
+{
+public:
+    FWStartupTaskGraph();
+    ~FWStartupTaskGraph();
+
+    // Объявить задачу. Зависимости указываются по именам ранее или позже объявленных задач
+    void AddTask(FName Name, EWStartupThread Thread, TArray<FName> Dependencies, TFunction<void()> Work);
+
+    // Выполнить все задачи. Вызывается на игровом потоке и возвращается после завершения графа
+    bool Run();
+
+    // Вывести отчет о запуске в лог
+    void LogReport() const;
+
+    // Общее время выполнения графа (мс)
+    float GetTotalTimeMs() const { return TotalTimeMs; }
+
+    // Критический путь: имена задач от первой к последней и его длительность (мс)
+    TArray<FName> GetCriticalPath(float* OutLengthMs = nullptr) const;
+
+private:
+    enum class ETaskState : uint8
+    {
+        Pending,
+        Running,
+        Done
+    };
+
+    struct FTask
+    {
+        FName Name;
+        EWStartupThread Thread;
+        TArray<FName> DependencyNames;
+        TArray<int32> Dependencies;
+        TFunction<void()> Work;
+        ETaskState State = ETaskState::Pending;
+
+        // Время относительно начала графа (секунды)
+        double StartTime = 0.0;
+        double EndTime = 0.0;
+    };
+
+    TArray<FTask> Tasks;
+
+    // Завершенные рабочие задачи (пишут рабочие потоки, читает игровой поток)
+    TQueue<int32, EQueueMode::Mpsc> CompletedWorkerTasks;
+    FEvent* WorkerDoneEvent;
+
+    double GraphStartTime;
+    float TotalTimeMs;
+
+    // Сопоставить имена зависимостей с индексами, false при неизвестной зависимости
+    bool ResolveDependencies();
+    bool AreDependenciesDone(const FTask& Task) const;
+    void ExecuteTask(int32 TaskIndex);
+    void LaunchWorkerTask(int32 TaskIndex);
+};
@@ -0,0 +1,186 @@
+#include "../WTowerHUDTextFormatter.h"
+#include "../WTowerHUDWidget.h"
+#include "../WTowerHUDBundle.h"
+#include "Components/TextBlock.h"
+#include "HAL/MemoryBase.h"
+#include "Misc/AutomationTest.h"
+#include "UObject/Package.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    // Считать выделения на этом потоке (для остальных потоков распределитель прозрачен)
+    thread_local bool bCountAllocations = false;
+    thread_local int32 NumThreadAllocations = 0;
+
+    /**
+     * Распределитель-обертка: пропускает все вызовы в исходный GMalloc
+     * и считает выделения потока, на котором включен подсчет.
+     * Устанавливается один раз и живет до конца процесса: другой поток
+     * может находиться внутри обертки в любой момент
+     */
+    class FWCountingMalloc : public FMalloc
+    {
+    public:
+        explicit FWCountingMalloc(FMalloc* InInner)
+            : Inner(InInner)
+        {
+        }
+
+        virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+        {
+            CountAllocation();
+            return Inner->Malloc(Count, Alignment);
+        }
+
+        virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+        {
+            CountAllocation();
+            return Inner->Realloc(Original, Count, Alignment);
+        }
+
+        virtual void Free(void* Original) override
+        {
+            Inner->Free(Original);
+        }
+
+        virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override
+        {
+            return Inner->QuantizeSize(Count, Alignment);
+        }
+
+        virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override
+        {
+            return Inner->GetAllocationSize(Original, SizeOut);
+        }
+
+        virtual bool IsInternallyThreadSafe() const override
+        {
+            return Inner->IsInternallyThreadSafe();
+        }
+
+        virtual const TCHAR* GetDescriptiveName() override
+        {
+            return TEXT("WCountingMalloc");
+        }
+
+    private:
+        FMalloc* Inner;
+
+        static void CountAllocation()
+        {
+            if (bCountAllocations)
+            {
+                ++NumThreadAllocations;
+            }
+        }
+    };
+
+    // Установить обертку при первом использовании (намеренно не удаляется)
+    void InstallCountingMalloc()
+    {
+        static bool bInstalled = false;
+        if (!bInstalled)
+        {
+            GMalloc = new FWCountingMalloc(GMalloc);
+            bInstalled = true;
+        }
+    }
+
+    // Количество выделений памяти текущим потоком при выполнении Body
+    template <typename FunctorType>
+    int32 CountAllocations(FunctorType&& Body)
+    {
+        InstallCountingMalloc();
+
+        NumThreadAllocations = 0;
+        bCountAllocations = true;
+        Body();
+        bCountAllocations = false;
+
+        return NumThreadAllocations;
+    }
+
+    // Верхняя граница выделений на одно изменение значения: строка числа, культурно-независимый
+    // текст-аргумент и история FText::Format с копией аргументов и отображаемой строкой
+    constexpr int32 MaxAllocationsPerChange = 16;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWTowerHUDAllocationTest, "Tower.HUD.TextAllocations",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FWTowerHUDAllocationTest::RunTest(const FString& Parameters)
+{
+    constexpr int32 NumFrames = 1000;
+    constexpr int32 NumChanges = 100;
+
+    // Форматирование: первый вызов строит текст, повторы с тем же значением отдают кэш
+    FWTowerHUDTextFormatter Formatter;
+    Formatter.FormatScore(1234);
+    Formatter.FormatTime(75);
+
+    const int32 UnchangedAllocations = CountAllocations([&Formatter]()
+        {
+            for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+            {
+                Formatter.FormatScore(1234);
+                Formatter.FormatTime(75);
+            }
+        });
+    TestEqual(TEXT("Allocations in FormatScore/FormatTime with unchanged values"), UnchangedAllocations, 0);
+
+    // Изменение значения выделяет память под новый FText, но в пределах фиксированной границы
+    // и без роста с номером изменения
+    const int32 ChangedAllocations = CountAllocations([&Formatter]()
+        {
+            for (int32 Change = 0; Change < NumChanges; ++Change)
+            {
+                Formatter.FormatScore(2000 + Change);
+            }
+        });
+    AddInfo(FString::Printf(TEXT("FormatScore allocations per change: %.2f"), static_cast<float>(ChangedAllocations) / NumChanges));
+    TestTrue(TEXT("Allocations per FormatScore change are bounded"), ChangedAllocations <= NumChanges * MaxAllocationsPerChange);
+
+    TestEqual(TEXT("Score text"), Formatter.FormatScore(1234).ToString(), FString(TEXT("Счет: 1234")));
+    TestEqual(TEXT("Time text"), Formatter.FormatTime(75).ToString(), FString(TEXT("Время: 01:15")));
+
+    // Виджет HUD с привязанными текстовыми блоками из его Blueprint
+    UClass* WidgetClass = FWHUDPreloadBundle().WidgetClass.LoadSynchronous();
+    if (!WidgetClass || !WidgetClass->IsChildOf(UWTowerHUDWidget::StaticClass()))
+    {
+        AddError(TEXT("HUD widget class could not be loaded"));
+        return false;
+    }
+
+    UWTowerHUDWidget* Widget = NewObject<UWTowerHUDWidget>(GetTransientPackage(), WidgetClass);
+    Widget->Initialize();
+    UTextBlock* ScoreText = Cast<UTextBlock>(Widget->GetWidgetFromName(TEXT("ScoreText")));
+    if (!ScoreText)
+    {
+        AddError(TEXT("HUD widget has no ScoreText"));
+        return false;
+    }
+
+    // Обновление статистики: каждый кадр проверяются значения, текст не меняется
+    Widget->InvalidateStats();
+    Widget->ApplyStats(1234, 75);
+
+    const int32 UpdateAllocations = CountAllocations([Widget]()
+        {
+            for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+            {
+                Widget->ApplyStats(1234, 75);
+            }
+        });
+    TestEqual(TEXT("Allocations in UpdateStats with unchanged values"), UpdateAllocations, 0);
+
+    // Изменившееся значение попадает в текст
+    Widget->ApplyStats(1235, 75);
+    TestEqual(TEXT("Updated score text"), ScoreText->GetText().ToString(), FString(TEXT("Счет: 1235")));
+
+    Widget->MarkAsGarbage();
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
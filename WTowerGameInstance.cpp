@@ -1,21 +1,40 @@
 #include "WTowerGameInstance.h"
 #include "Kismet/GameplayStatics.h"
 #include "SaveGame/WTowerSaveGame.h"
+#include "SaveGame/WSaveService.h"
 #include "Config/WTowerGameConfig.h"
 #include "Audio/WAudioManager.h"
 #include "Misc/FileHelper.h"
 #include "Misc/Paths.h"
 #include "JsonObjectConverter.h"
 #include "WTowerGameState.h"
+#include "Gameplay/WTowerRunSubsystem.h"
+#include "Startup/WStartupTaskGraph.h"
+#include "HAL/FileManager.h"
+#include "Misc/App.h"
+#include "Async/Async.h"
+#include "WTowerStats.h"
+#include "WTowerMemory.h"
 
 UWTowerGameInstance::UWTowerGameInstance()
 {
     // Инициализация переменных по умолчанию
+    // Слот по умолчанию, пока профилей нет; иначе берется последний выбранный из индекса
     CurrentSaveSlot = TEXT("DefaultSave");
     CurrentSaveGame = nullptr;
+    ProfileIndex = nullptr;
+    bProfileLoadInFlight = false;
+    PendingRunHistory = nullptr;
+    SaveService = nullptr;
+    SaveJournal = nullptr;
+    RunHistory = nullptr;
     GameConfig = nullptr;
+    ConfigService = nullptr;
     AudioManager = nullptr;
+    LevelRegistry = nullptr;
+    TransitionService = nullptr;
     CurrentLevelIndex = 0;
+    StartupTimeMs = 0.0f;
     
     // Установка путей для файлов настроек
     ConfigFolder = FPaths::ProjectSavedDir() + TEXT("Config/");
@@ -25,27 +44,179 @@ UWTowerGameInstance::UWTowerGameInstance()
 void UWTowerGameInstance::Init()
 {
     Super::Init();
-    
-    // Создаем директорию для настроек, если она не существует
-    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
-    if (!PlatformFile.DirectoryExists(*ConfigFolder))
+
+    // Запуск разбит на задачи: чтение файлов идет на рабочих потоках,
+    // создание UObject и применение данных - на игровом потоке по готовности зависимостей
+    FWStartupTaskGraph Startup;
+
+    // Данные, передаваемые между задачами (граф выполняется внутри Init)
+    FWConfigReadResult ConfigRead;
+    bool bConfigLoaded = false;
+    TArray<uint8> SavePayload;
+    bool bSaveRead = false;
+
+    Startup.AddTask(TEXT("CreateDirectories"), EWStartupThread::Worker, {}, [this]()
+        {
+            // Создаем директорию для настроек, если она не существует
+            IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+            if (!PlatformFile.DirectoryExists(*ConfigFolder))
+            {
+                PlatformFile.CreateDirectoryTree(*ConfigFolder);
+            }
+        });
+
+    Startup.AddTask(TEXT("ReadConfig"), EWStartupThread::Worker, {}, [this, &ConfigRead]()
+        {
+            // Снимок проверяется по хешу JSON, JSON разбирается только если снимок устарел
+            ConfigRead = UWConfigService::ReadConfigFiles(ConfigFilePath);
+        });
+
+    Startup.AddTask(TEXT("ProfileIndex"), EWStartupThread::GameThread, {}, [this]()
+        {
+            ProfileIndex = NewObject<UWProfileIndex>(this);
+        });
+
+    Startup.AddTask(TEXT("LoadProfileIndex"), EWStartupThread::Worker, { TEXT("ProfileIndex") }, [this]()
+        {
+            // Читается только маленький индекс, полный слот - лишь выбранного профиля
+            ProfileIndex->LoadIndex();
+            if (!ProfileIndex->GetLastSlot().IsEmpty())
+            {
+                CurrentSaveSlot = ProfileIndex->GetLastSlot();
+            }
+        });
+
+    Startup.AddTask(TEXT("ReadSave"), EWStartupThread::Worker, { TEXT("LoadProfileIndex") }, [this, &SavePayload, &bSaveRead]()
+        {
+            // Чтение и проверка контрольной суммы не трогают UObject
+            if (IFileManager::Get().FileExists(*UWSaveService::GetSlotFilePath(CurrentSaveSlot)))
+            {
+                bSaveRead = UWSaveService::ReadSlotPayload(CurrentSaveSlot, SavePayload);
+            }
+        });
+
+    Startup.AddTask(TEXT("SaveService"), EWStartupThread::GameThread, {}, [this]()
+        {
+            SaveService = NewObject<UWSaveService>(this);
+            SaveService->Initialize();
+            SaveService->OnSaveCompleted.AddDynamic(this, &UWTowerGameInstance::OnSlotSaved);
+
+            SaveJournal = NewObject<UWSaveJournal>(this);
+            SaveJournal->Initialize(SaveService);
+            SaveJournal->OnJournalFlushed.AddUObject(this, &UWTowerGameInstance::OnJournalFlushed);
+        });
+
+    Startup.AddTask(TEXT("RunHistory"), EWStartupThread::GameThread, { TEXT("LoadProfileIndex") }, [this]()
+        {
+            RunHistory = NewObject<UWRunHistory>(this);
+            RunHistory->Initialize(CurrentSaveSlot);
+        });
+
+    Startup.AddTask(TEXT("LoadRunIndex"), EWStartupThread::Worker, { TEXT("RunHistory") }, [this]()
+        {
+            // Индекс читается (или дополняется по файлу истории) без UObject
+            RunHistory->LoadIndex();
+        });
+
+    Startup.AddTask(TEXT("LevelRegistry"), EWStartupThread::GameThread, {}, [this]()
+        {
+            InitializeLevelSequence();
+        });
+
+    Startup.AddTask(TEXT("TransitionService"), EWStartupThread::GameThread, { TEXT("LevelRegistry") }, [this]()
+        {
+            // Сервис переходов подхватывает загрузку карт и готовит следующий уровень
+            TransitionService = NewObject<UWLevelTransitionService>(this);
+            TransitionService->Initialize(this);
+        });
+
+    Startup.AddTask(TEXT("LoadSave"), EWStartupThread::GameThread, { TEXT("ReadSave"), TEXT("SaveService"), TEXT("LevelRegistry"), TEXT("LoadProfileIndex") },
+        [this, &SavePayload, &bSaveRead]()
+        {
+            // Реестр уровней нужен до загрузки сохранения для миграции прогресса
+            ApplyLoadedSaveGame(bSaveRead ? UWSaveService::LoadSlotFromPayload(SavePayload) : nullptr);
+        });
+
+    Startup.AddTask(TEXT("ApplyConfig"), EWStartupThread::GameThread, { TEXT("ReadConfig") }, [this, &ConfigRead, &bConfigLoaded]()
+        {
+            bConfigLoaded = InitializeGameConfig(ConfigRead);
+        });
+
+    Startup.AddTask(TEXT("WriteDefaultConfig"), EWStartupThread::GameThread, { TEXT("ApplyConfig"), TEXT("CreateDirectories") }, [this, &bConfigLoaded]()
+        {
+            // Снимок делается сразу, запись файлов идет в фоне
+            if (!bConfigLoaded)
+            {
+                SaveGameConfig();
+            }
+        });
+
+    Startup.AddTask(TEXT("ConfigWatcher"), EWStartupThread::GameThread, { TEXT("WriteDefaultConfig") }, [this]()
+        {
+            ConfigService->StartWatching();
+        });
+
+    Startup.AddTask(TEXT("AudioManager"), EWStartupThread::GameThread, { TEXT("ApplyConfig") }, [this]()
+        {
+            // Создаем и инициализируем аудио менеджер
+            AudioManager = NewObject<UWAudioManager>(this);
+            if (AudioManager)
+            {
+                AudioManager->Initialize(this);
+            }
+        });
+
+    if (!Startup.Run())
     {
-        PlatformFile.CreateDirectoryTree(*ConfigFolder);
+        UE_LOG(LogTemp, Error, TEXT("WTowerGameInstance: Startup graph failed"));
     }
+
+    StartupTimeMs = Startup.GetTotalTimeMs();
+    Startup.LogReport();
     
-    // Инициализируем сохранение и настройки
-    InitializeSaveGame();
-    InitializeGameConfig();
-    InitializeLevelSequence();
-    
-    // Создаем и инициализируем аудио менеджер
-    AudioManager = NewObject<UWAudioManager>(this);
-    if (AudioManager)
+    UE_LOG(LogTemp, Log, TEXT("WTowerGameInstance: Initialized in %.2f ms (build %s)"), StartupTimeMs, FApp::GetBuildVersion());
+}
+
+void UWTowerGameInstance::Shutdown()
+{
+    // Дописываем журнал и ожидающие сохранения до выхода
+    if (SaveJournal)
     {
-        AudioManager->Initialize(this);
+        SaveJournal->Close();
     }
-    
-    UE_LOG(LogTemp, Log, TEXT("WTowerGameInstance: Initialized"));
+
+    if (SaveService)
+    {
+        SaveService->Shutdown();
+    }
+
+    if (TransitionService)
+    {
+        TransitionService->Shutdown();
+    }
+
+    if (ConfigService)
+    {
+        ConfigService->Shutdown();
+    }
+
+    // Фоновая загрузка профиля пишет в PendingRunHistory
+    if (ProfileLoad.IsValid())
+    {
+        ProfileLoad.Wait();
+    }
+
+    if (RunHistory)
+    {
+        RunHistory->Shutdown();
+    }
+
+    if (ProfileIndex)
+    {
+        ProfileIndex->Shutdown();
+    }
+
+    Super::Shutdown();
 }
 
 //----------------------------------------------------------------------------------------
@@ -55,109 +226,342 @@ void UWTowerGameInstance::Init()
 void UWTowerGameInstance::InitializeSaveGame()
 {
     // Проверяем существующее сохранение
-    if (UGameplayStatics::DoesSaveGameExist(CurrentSaveSlot, 0))
+    UWTowerSaveGame* LoadedSave = nullptr;
+    if (SaveService->DoesSlotExist(CurrentSaveSlot))
+    {
+        LoadedSave = SaveService->LoadSlot(CurrentSaveSlot);
+    }
+    ApplyLoadedSaveGame(LoadedSave);
+}
+
+void UWTowerGameInstance::ApplyLoadedSaveGame(UWTowerSaveGame* LoadedSave)
+{
+    WTOWER_SCOPE_CYCLE(STAT_TowerApplySave);
+    LLM_SCOPE_BYTAG(Tower_Save);
+
+    CurrentSaveGame = LoadedSave;
+    if (CurrentSaveGame)
     {
-        // Загружаем существующее сохранение
-        CurrentSaveGame = Cast<UWTowerSaveGame>(UGameplayStatics::LoadGameFromSlot(CurrentSaveSlot, 0));
         UE_LOG(LogTemp, Log, TEXT("WTowerGameInstance: Loaded existing save game"));
     }
     
-    // Если сохранения нет, создаем новое
+    // Если сохранения нет, создаем новое с разблокированным первым уровнем
     if (!CurrentSaveGame)
     {
         CurrentSaveGame = Cast<UWTowerSaveGame>(UGameplayStatics::CreateSaveGameObject(UWTowerSaveGame::StaticClass()));
+        CurrentSaveGame->MigrateLegacyProgress(LevelRegistry);
+        const int32 FirstLevelId = LevelRegistry->GetFirstPlayableLevelId();
+        if (FirstLevelId != INDEX_NONE)
+        {
+            CurrentSaveGame->UnlockLevel(FirstLevelId);
+        }
         UE_LOG(LogTemp, Log, TEXT("WTowerGameInstance: Created new save game"));
     }
+    else if (CurrentSaveGame->MigrateLegacyProgress(LevelRegistry))
+    {
+        // Сохраняем уже в новом формате
+        SaveGame();
+    }
+
+    // Изменения, записанные в журнал после снимка, применяются поверх него
+    if (SaveJournal)
+    {
+        SaveJournal->Open(CurrentSaveSlot, CurrentSaveGame);
+    }
+
+    // Заголовок приводим к загруженным данным (в том числе для слотов, подхваченных по имени файла)
+    if (ProfileIndex && (LoadedSave || !ProfileIndex->FindProfile(CurrentSaveSlot)))
+    {
+        ProfileIndex->UpdateProfile(CurrentSaveSlot, CurrentSaveGame, GetNumPlayableLevels());
+        ProfileIndex->SetLastSlot(CurrentSaveSlot);
+        ProfileIndex->SaveIndex();
+    }
 }
 
 bool UWTowerGameInstance::SaveGame()
 {
-    if (CurrentSaveGame)
+    WTOWER_SCOPE_CYCLE(STAT_TowerSaveGame);
+
+    if (CurrentSaveGame && SaveService)
     {
-        // Сохраняем текущий прогресс
-        return UGameplayStatics::SaveGameToSlot(CurrentSaveGame, CurrentSaveSlot, 0);
+        // Помечаем прогресс измененным: несколько вызовов подряд дадут одну фоновую запись
+        CurrentSaveGame->TouchSaveDate();
+        SaveService->MarkDirty(CurrentSaveGame, CurrentSaveSlot);
+        return true;
     }
     return false;
 }
 
 bool UWTowerGameInstance::LoadGame()
 {
-    if (UGameplayStatics::DoesSaveGameExist(CurrentSaveSlot, 0))
+    WTOWER_SCOPE_CYCLE(STAT_TowerLoadGame);
+
+    if (SaveService && SaveService->DoesSlotExist(CurrentSaveSlot))
     {
-        // Загружаем сохраненный прогресс
-        CurrentSaveGame = Cast<UWTowerSaveGame>(UGameplayStatics::LoadGameFromSlot(CurrentSaveSlot, 0));
-        return CurrentSaveGame != nullptr;
+        // Загружаем сохраненный прогресс вместе с журналом изменений
+        UWTowerSaveGame* LoadedSave = SaveService->LoadSlot(CurrentSaveSlot);
+        if (LoadedSave)
+        {
+            ApplyLoadedSaveGame(LoadedSave);
+            return true;
+        }
     }
     return false;
 }
 
+//----------------------------------------------------------------------------------------
+// ПРОФИЛИ
+//----------------------------------------------------------------------------------------
+
+TArray<FWProfileHeader> UWTowerGameInstance::GetProfiles() const
+{
+    return ProfileIndex ? ProfileIndex->GetProfiles() : TArray<FWProfileHeader>();
+}
+
+void UWTowerGameInstance::SelectProfile(const FString& SlotName)
+{
+    if (!ProfileIndex || !ProfileIndex->FindProfile(SlotName))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("WTowerGameInstance: Unknown profile %s"), *SlotName);
+        OnProfileLoaded.Broadcast(SlotName, false);
+        return;
+    }
+
+    if (SlotName == CurrentSaveSlot && !bProfileLoadInFlight)
+    {
+        OnProfileLoaded.Broadcast(SlotName, true);
+        return;
+    }
+
+    // Пока идет загрузка, запоминаем только последний выбор
+    PendingProfileSlot = SlotName;
+    if (bProfileLoadInFlight)
+        return;
+
+    // Изменения текущего профиля уходят на запись до переключения
+    if (SaveService)
+    {
+        SaveService->FlushNow();
+    }
+
+    bProfileLoadInFlight = true;
+    PendingRunHistory = NewObject<UWRunHistory>(this);
+    PendingRunHistory->Initialize(SlotName);
+
+    // Слот и индекс истории читаются на рабочем потоке, объекты создаются на игровом
+    TWeakObjectPtr<UWTowerGameInstance> WeakThis(this);
+    UWRunHistory* History = PendingRunHistory;
+    ProfileLoad = Async(EAsyncExecution::ThreadPool, [WeakThis, SlotName, History]()
+    {
+        TArray<uint8> Payload;
+        const bool bRead = UWSaveService::ReadSlotPayload(SlotName, Payload);
+        History->LoadIndex();
+
+        AsyncTask(ENamedThreads::GameThread, [WeakThis, SlotName, bRead, Payload = MoveTemp(Payload)]()
+        {
+            if (UWTowerGameInstance* GameInstance = WeakThis.Get())
+            {
+                GameInstance->OnProfileSlotRead(SlotName, bRead, Payload);
+            }
+        });
+    });
+}
+
+void UWTowerGameInstance::OnProfileSlotRead(const FString& SlotName, bool bRead, const TArray<uint8>& Payload)
+{
+    bProfileLoadInFlight = false;
+
+    // Пока слот читался, был выбран другой профиль
+    if (PendingProfileSlot != SlotName)
+    {
+        PendingRunHistory = nullptr;
+        SelectProfile(PendingProfileSlot);
+        return;
+    }
+
+    UWTowerSaveGame* LoadedSave = bRead ? UWSaveService::LoadSlotFromPayload(Payload) : nullptr;
+    if (!LoadedSave && SaveService->DoesSlotExist(SlotName))
+    {
+        // Файл поврежден: текущий профиль не трогаем
+        UE_LOG(LogTemp, Error, TEXT("WTowerGameInstance: Failed to load profile %s"), *SlotName);
+        PendingRunHistory = nullptr;
+        OnProfileLoaded.Broadcast(SlotName, false);
+        return;
+    }
+
+    SwitchToSlot(SlotName);
+    RunHistory = PendingRunHistory;
+    PendingRunHistory = nullptr;
+
+    // Профиль создан, но ни разу не сохранялся: новое сохранение с именем из индекса
+    const FWProfileHeader Header = *ProfileIndex->FindProfile(SlotName);
+    ApplyLoadedSaveGame(LoadedSave);
+    if (!LoadedSave)
+    {
+        CurrentSaveGame->SetUserName(Header.UserName);
+        CurrentSaveGame->SetThumbnail(Header.Thumbnail);
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("WTowerGameInstance: Profile %s loaded"), *SlotName);
+    OnProfileLoaded.Broadcast(SlotName, true);
+}
+
+FString UWTowerGameInstance::CreateProfile(const FString& UserName, const FSoftObjectPath& Thumbnail)
+{
+    if (!ProfileIndex || bProfileLoadInFlight)
+        return FString();
+
+    if (SaveService)
+    {
+        SaveService->FlushNow();
+    }
+
+    const FString SlotName = ProfileIndex->AddProfile(UserName, Thumbnail);
+    SwitchToSlot(SlotName);
+    RunHistory = NewObject<UWRunHistory>(this);
+    RunHistory->Initialize(SlotName);
+
+    // У нового профиля нет файлов, поэтому он создается без загрузки
+    ApplyLoadedSaveGame(nullptr);
+    CurrentSaveGame->SetUserName(UserName);
+    CurrentSaveGame->SetThumbnail(Thumbnail);
+    SaveGame();
+
+    OnProfileLoaded.Broadcast(SlotName, true);
+    return SlotName;
+}
+
+void UWTowerGameInstance::SwitchToSlot(const FString& SlotName)
+{
+    if (RunHistory)
+    {
+        RunHistory->Shutdown();
+    }
+
+    CurrentSaveSlot = SlotName;
+    ProfileIndex->SetLastSlot(SlotName);
+    ProfileIndex->SaveIndex();
+}
+
+void UWTowerGameInstance::OnSlotSaved(const FString& SlotName, bool bSuccess)
+{
+    // Заголовок обновляется только после записи слота, чтобы индекс не опережал данные
+    if (bSuccess && ProfileIndex && CurrentSaveGame && SlotName == CurrentSaveSlot)
+    {
+        ProfileIndex->UpdateProfile(SlotName, CurrentSaveGame, GetNumPlayableLevels());
+        ProfileIndex->SaveIndex();
+    }
+}
+
+void UWTowerGameInstance::OnJournalFlushed(const FString& SlotName, UWTowerSaveGame* FlushedSave)
+{
+    // Снимок слота теперь пишется только при уплотнении, поэтому заголовок обновляется
+    // по журналу: в памяти сразу, на диске одной записью на серию событий
+    if (!ProfileIndex || !FlushedSave)
+        return;
+
+    FlushedSave->TouchSaveDate();
+    ProfileIndex->UpdateProfile(SlotName, FlushedSave, GetNumPlayableLevels());
+    ProfileIndex->RequestSave();
+}
+
+int32 UWTowerGameInstance::GetNumPlayableLevels() const
+{
+    int32 Count = 0;
+    if (LevelRegistry)
+    {
+        for (int32 Index = 0; Index < LevelRegistry->GetNumLevels(); ++Index)
+        {
+            if (!LevelRegistry->GetEntryAt(Index).bIsMenu)
+            {
+                ++Count;
+            }
+        }
+    }
+    return Count;
+}
+
+void UWTowerGameInstance::RecordCompletedRun()
+{
+    UWTowerRunSubsystem* Run = UWTowerRunSubsystem::Get(this);
+    AWTowerGameState* GameState = Run ? Run->GetTowerGameState() : nullptr;
+    const int32 LevelId = GetCurrentLevelId();
+    if (!RunHistory || !GameState || LevelId == INDEX_NONE)
+        return;
+
+    FWRunRecord Record;
+    Record.Seed = Run->GetRunSeed();
+    Record.LevelId = static_cast<uint16>(LevelId);
+    Record.PowerUpMask = Run->GetPowerUpMask();
+    Record.PowerUpCount = static_cast<uint16>(FMath::Min(Run->GetPowerUpCount(), static_cast<int32>(MAX_uint16)));
+    Record.Time = GameState->GetGameTime();
+    Record.Score = GameState->GetScore();
+    Record.MaxHeight = GameState->GetPlayerMaxHeight();
+    Record.Timestamp = FDateTime::UtcNow().ToUnixTimestamp();
+
+    RunHistory->AppendRun(Record);
+}
+
 //----------------------------------------------------------------------------------------
 // МЕТОДЫ УПРАВЛЕНИЯ НАСТРОЙКАМИ
 //----------------------------------------------------------------------------------------
 
-void UWTowerGameInstance::InitializeGameConfig()
+bool UWTowerGameInstance::InitializeGameConfig(const FWConfigReadResult& ConfigRead)
 {
-    // Создаем объект конфигурации
+    // Создаем объект конфигурации и сервис настроек
     GameConfig = NewObject<UWTowerGameConfig>(this);
+    ConfigService = NewObject<UWConfigService>(this);
+    ConfigService->Initialize(this, ConfigFilePath);
     
-    // Пытаемся загрузить настройки из файла
-    LoadGameConfig();
-    
-    // Если не удалось загрузить, используем настройки по умолчанию
-    if (!GameConfig->IsInitialized())
+    // Применяем настройки из снимка или JSON
+    if (ConfigService->ApplyReadResult(GameConfig, ConfigRead))
     {
-        GameConfig->InitializeDefaultSettings();
-        SaveGameConfig();
+        return true;
     }
+    
+    // Если не удалось загрузить, используем настройки по умолчанию
+    GameConfig->InitializeDefaultSettings();
+    return false;
 }
 
 void UWTowerGameInstance::SaveGameConfig()
 {
-    if (GameConfig)
+    WTOWER_SCOPE_CYCLE(STAT_TowerConfigSave);
+
+    if (GameConfig && ConfigService)
     {
-        // Сериализуем GameConfig в JSON
-        FString JsonOutput;
-        FJsonObjectConverter::UStructToJsonObjectString(GameConfig->GetClass(), GameConfig, JsonOutput, 0, 0);
-        
-        // Записываем JSON в файл
-        FFileHelper::SaveStringToFile(JsonOutput, *ConfigFilePath);
+        // JSON и двоичный снимок записываются в фоне
+        ConfigService->SaveConfig(GameConfig);
     }
 }
 
 void UWTowerGameInstance::LoadGameConfig()
 {
-    FString JsonString;
+    WTOWER_SCOPE_CYCLE(STAT_TowerConfigLoad);
 
-    // Проверяем существование файла настроек
-    if (FFileHelper::LoadFileToString(JsonString, *ConfigFilePath))
+    if (GameConfig && ConfigService)
     {
-        // Сначала создаем JSON объект
-        TSharedPtr<FJsonObject> JsonObject;
-        TSharedRef<TJsonReader<>> JsonReader = TJsonReaderFactory<>::Create(JsonString);
-
-        if (FJsonSerializer::Deserialize(JsonReader, JsonObject) && JsonObject.IsValid())
-        {
-            // Затем преобразуем JSON объект в структуру используя JsonObjectToUStruct
-            FJsonObjectConverter::JsonObjectToUStruct(
-                JsonObject.ToSharedRef(),
-                GameConfig->GetClass(),
-                GameConfig,
-                0, 0);
-            GameConfig->SetInitialized(true);
-        }
+        ConfigService->LoadConfig(GameConfig);
     }
 }
 
 void UWTowerGameInstance::ApplySettings()
 {
+    ApplySettingsSections(EWConfigSection::All);
+}
+
+void UWTowerGameInstance::ApplySettingsSections(EWConfigSection Sections)
+{
+    WTOWER_SCOPE_CYCLE(STAT_TowerConfigApply);
+
     // Применяем настройки графики
-    if (GameConfig)
+    if (GameConfig && EnumHasAnyFlags(Sections, EWConfigSection::Graphics))
     {
         GameConfig->ApplyGraphicsSettings();
     }
     
     // Применяем настройки звука
-    if (AudioManager)
+    if (AudioManager && EnumHasAnyFlags(Sections, EWConfigSection::Audio))
     {
         AudioManager->ApplySoundSettings();
     }
@@ -169,12 +573,25 @@ void UWTowerGameInstance::ApplySettings()
 
 void UWTowerGameInstance::InitializeLevelSequence()
 {
-    // Заполняем массив уровней (названия должны совпадать с названиями файлов карт)
-    LevelSequence.Add(TEXT("MainMenu"));
-    LevelSequence.Add(TEXT("Level_1"));
-    LevelSequence.Add(TEXT("Level_2"));
-    LevelSequence.Add(TEXT("Level_3"));
-    // Добавьте другие уровни по мере необходимости
+    // Загружаем реестр уровней из ассета или используем последовательность по умолчанию
+    if (!LevelRegistryAsset.IsNull())
+    {
+        LevelRegistry = LevelRegistryAsset.LoadSynchronous();
+    }
+
+    if (LevelRegistry)
+    {
+        LevelRegistry->BuildLookup();
+    }
+    else
+    {
+        LevelRegistry = UWLevelRegistry::CreateDefault(this);
+    }
+}
+
+int32 UWTowerGameInstance::GetCurrentLevelId() const
+{
+    return LevelRegistry ? LevelRegistry->GetEntryAt(CurrentLevelIndex).LevelId : INDEX_NONE;
 }
 
 void UWTowerGameInstance::LoadNextLevel()
@@ -183,28 +600,41 @@ void UWTowerGameInstance::LoadNextLevel()
     CurrentLevelIndex++;
     
     // Проверяем, не вышли ли за пределы массива
-    if (CurrentLevelIndex >= LevelSequence.Num())
+    if (CurrentLevelIndex >= LevelRegistry->GetNumLevels())
     {
         // Если это последний уровень, возвращаемся в главное меню
         CurrentLevelIndex = 0;
     }
+
+    // Следующий уровень становится доступным в прогрессе
+    const FWLevelEntry& NextEntry = LevelRegistry->GetEntryAt(CurrentLevelIndex);
+    if (!NextEntry.bIsMenu)
+    {
+        UnlockLevel(NextEntry.LevelId);
+    }
     
-    // Загружаем уровень
-    UGameplayStatics::OpenLevel(GetWorld(), FName(*LevelSequence[CurrentLevelIndex]));
+    // Загружаем уровень (обычно он уже предзагружен в фоне)
+    TransitionService->TravelToLevel(CurrentLevelIndex);
 }
 
 void UWTowerGameInstance::RestartCurrentLevel()
 {
+    // Сначала пробуем перезапустить забег на месте, без перезагрузки карты
+    UWTowerRunSubsystem* Run = UWTowerRunSubsystem::Get(this);
+    if (Run && Run->SoftResetRun(false))
+    {
+        return;
+    }
+
     // Перезапускаем текущий уровень
-    FString CurrentLevel = LevelSequence[CurrentLevelIndex];
-    UGameplayStatics::OpenLevel(GetWorld(), FName(*CurrentLevel));
+    TransitionService->TravelToLevel(CurrentLevelIndex);
 }
 
 void UWTowerGameInstance::OpenMainMenu()
 {
     // Устанавливаем индекс на главное меню и открываем его
     CurrentLevelIndex = 0;
-    UGameplayStatics::OpenLevel(GetWorld(), FName(*LevelSequence[CurrentLevelIndex]));
+    TransitionService->TravelToLevel(CurrentLevelIndex);
 }
 
 //----------------------------------------------------------------------------------------
@@ -213,32 +643,72 @@ void UWTowerGameInstance::OpenMainMenu()
 
 void UWTowerGameInstance::UpdateBestCompletionTime(const FString& LevelName, float NewTime)
 {
+    // Имя переводится в идентификатор один раз, дальше работаем с плотным массивом
+    const int32 LevelId = LevelRegistry ? LevelRegistry->FindLevelId(FName(*LevelName)) : INDEX_NONE;
+    if (LevelId == INDEX_NONE)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("WTowerGameInstance: Unknown level %s"), *LevelName);
+        return;
+    }
+    UpdateLevelBestTime(LevelId, NewTime);
+}
+
+void UWTowerGameInstance::UpdateBestScore(const FString& LevelName, int32 NewScore)
+{
+    const int32 LevelId = LevelRegistry ? LevelRegistry->FindLevelId(FName(*LevelName)) : INDEX_NONE;
+    if (LevelId == INDEX_NONE)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("WTowerGameInstance: Unknown level %s"), *LevelName);
+        return;
+    }
+    UpdateLevelBestScore(LevelId, NewScore);
+}
+
+void UWTowerGameInstance::UpdateLevelBestTime(int32 LevelId, float NewTime)
+{
+    WTOWER_SCOPE_CYCLE(STAT_TowerSaveProgress);
+
     if (CurrentSaveGame)
     {
         // Обновляем лучшее время прохождения, если оно лучше предыдущего
-        float CurrentBestTime = CurrentSaveGame->GetBestCompletionTime(LevelName);
+        float CurrentBestTime = CurrentSaveGame->GetBestCompletionTime(LevelId);
         if (CurrentBestTime <= 0.0f || NewTime < CurrentBestTime)
         {
-            CurrentSaveGame->SetBestCompletionTime(LevelName, NewTime);
-            SaveGame();
+            CurrentSaveGame->SetBestCompletionTime(LevelId, NewTime);
+            SaveJournal->AppendBestTime(LevelId, NewTime);
             
-            UE_LOG(LogTemp, Log, TEXT("WTowerGameInstance: Updated best time for %s: %.2f seconds"), *LevelName, NewTime);
+            UE_LOG(LogTemp, Log, TEXT("WTowerGameInstance: Updated best time for level %d: %.2f seconds"), LevelId, NewTime);
         }
     }
 }
 
-void UWTowerGameInstance::UpdateBestScore(const FString& LevelName, int32 NewScore)
+void UWTowerGameInstance::UpdateLevelBestScore(int32 LevelId, int32 NewScore)
 {
+    WTOWER_SCOPE_CYCLE(STAT_TowerSaveProgress);
+
     if (CurrentSaveGame)
     {
         // Обновляем лучший счет, если он выше предыдущего
-        int32 CurrentBestScore = CurrentSaveGame->GetBestScore(LevelName);
+        int32 CurrentBestScore = CurrentSaveGame->GetBestScore(LevelId);
         if (NewScore > CurrentBestScore)
         {
-            CurrentSaveGame->SetBestScore(LevelName, NewScore);
-            SaveGame();
+            CurrentSaveGame->SetBestScore(LevelId, NewScore);
+            SaveJournal->AppendBestScore(LevelId, NewScore);
             
-            UE_LOG(LogTemp, Log, TEXT("WTowerGameInstance: Updated best score for %s: %d"), *LevelName, NewScore);
+            UE_LOG(LogTemp, Log, TEXT("WTowerGameInstance: Updated best score for level %d: %d"), LevelId, NewScore);
         }
     }
+}
+
+void UWTowerGameInstance::UnlockLevel(int32 LevelId)
+{
+    WTOWER_SCOPE_CYCLE(STAT_TowerSaveProgress);
+
+    if (CurrentSaveGame && LevelId != INDEX_NONE && !CurrentSaveGame->IsLevelUnlocked(LevelId))
+    {
+        CurrentSaveGame->UnlockLevel(LevelId);
+        SaveJournal->AppendLevelUnlocked(LevelId);
+
+        UE_LOG(LogTemp, Log, TEXT("WTowerGameInstance: Unlocked level %d"), LevelId);
+    }
 }
\ No newline at end of file
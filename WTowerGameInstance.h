@@ -3,8 +3,16 @@
 #include "CoreMinimal.h"
 #include "Engine/GameInstance.h"
 #include "SaveGame/WTowerSaveGame.h"
+#include "SaveGame/WSaveService.h"
+#include "SaveGame/WSaveJournal.h"
+#include "SaveGame/WRunHistory.h"
+#include "SaveGame/WProfileIndex.h"
 #include "Config/WTowerGameConfig.h"
+#include "Config/WConfigService.h"
 #include "Audio/WAudioManager.h"
+#include "Levels/WLevelRegistry.h"
+#include "Levels/WLevelTransitionService.h"
+#include "WTowerHUDBundle.h"
 #include "WTowerGameInstance.generated.h"
 
 /**
@@ -23,6 +31,9 @@ public:
     // Инициализация GameInstance при запуске
     virtual void Init() override;
 
+    // Завершение работы (дописывает ожидающие сохранения)
+    virtual void Shutdown() override;
+
     //----------------------------------------------------------------------------------------
     // УПРАВЛЕНИЕ СОХРАНЕНИЯМИ
     //----------------------------------------------------------------------------------------
@@ -31,7 +42,7 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Сохранение|Загрузка")
     void InitializeSaveGame();
     
-    // Сохранить текущий прогресс
+    // Сохранить текущий прогресс (запись выполняется асинхронно и объединяется)
     UFUNCTION(BlueprintCallable, Category = "Сохранение|Загрузка")
     bool SaveGame();
     
@@ -43,6 +54,48 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Сохранение|Загрузка")
     UWTowerSaveGame* GetSaveGame() const { return CurrentSaveGame; }
 
+    // Получить сервис сохранения
+    UFUNCTION(BlueprintCallable, Category = "Сохранение|Загрузка")
+    UWSaveService* GetSaveService() const { return SaveService; }
+
+    // Получить журнал изменений сохранения
+    UWSaveJournal* GetSaveJournal() const { return SaveJournal; }
+
+    //----------------------------------------------------------------------------------------
+    // ПРОФИЛИ
+    //----------------------------------------------------------------------------------------
+
+    // Заголовки всех профилей (читаются из индекса, слоты не загружаются)
+    UFUNCTION(BlueprintCallable, Category = "Сохранение|Профили")
+    TArray<FWProfileHeader> GetProfiles() const;
+
+    // Выбрать профиль: слот загружается в фоне, по готовности вызывается OnProfileLoaded
+    UFUNCTION(BlueprintCallable, Category = "Сохранение|Профили")
+    void SelectProfile(const FString& SlotName);
+
+    // Создать новый профиль и сделать его текущим, возвращает имя слота
+    UFUNCTION(BlueprintCallable, Category = "Сохранение|Профили")
+    FString CreateProfile(const FString& UserName, const FSoftObjectPath& Thumbnail);
+
+    // Слот текущего профиля
+    UFUNCTION(BlueprintCallable, Category = "Сохранение|Профили")
+    FString GetCurrentSaveSlot() const { return CurrentSaveSlot; }
+
+    // Получить индекс профилей
+    UWProfileIndex* GetProfileIndex() const { return ProfileIndex; }
+
+    // Профиль загружен и стал текущим
+    UPROPERTY(BlueprintAssignable, Category = "Сохранение|Профили")
+    FOnWProfileLoaded OnProfileLoaded;
+
+    // Получить историю забегов профиля
+    UFUNCTION(BlueprintCallable, Category = "Сохранение|История")
+    UWRunHistory* GetRunHistory() const { return RunHistory; }
+
+    // Записать завершенный забег текущего уровня в историю
+    UFUNCTION(BlueprintCallable, Category = "Сохранение|История")
+    void RecordCompletedRun();
+
     //----------------------------------------------------------------------------------------
     // УПРАВЛЕНИЕ НАСТРОЙКАМИ
     //----------------------------------------------------------------------------------------
@@ -63,6 +116,12 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Настройки")
     void ApplySettings();
 
+    // Применить только указанные разделы настроек
+    void ApplySettingsSections(EWConfigSection Sections);
+
+    // Получить сервис настроек
+    UWConfigService* GetConfigService() const { return ConfigService; }
+
     //----------------------------------------------------------------------------------------
     // УПРАВЛЕНИЕ УРОВНЯМИ
     //----------------------------------------------------------------------------------------
@@ -78,6 +137,30 @@ public:
     // Открыть главное меню
     UFUNCTION(BlueprintCallable, Category = "Уровни")
     void OpenMainMenu();
+
+    // Получить реестр уровней
+    UFUNCTION(BlueprintCallable, Category = "Уровни")
+    UWLevelRegistry* GetLevelRegistry() const { return LevelRegistry; }
+
+    // Идентификатор текущего уровня
+    UFUNCTION(BlueprintCallable, Category = "Уровни")
+    int32 GetCurrentLevelId() const;
+
+    // Позиция текущего уровня в последовательности
+    UFUNCTION(BlueprintCallable, Category = "Уровни")
+    int32 GetCurrentLevelIndex() const { return CurrentLevelIndex; }
+
+    // Получить сервис переходов между уровнями
+    UFUNCTION(BlueprintCallable, Category = "Уровни")
+    UWLevelTransitionService* GetLevelTransitionService() const { return TransitionService; }
+
+    // Время запуска GameInstance по графу задач (мс)
+    UFUNCTION(BlueprintCallable, Category = "Уровни")
+    float GetStartupTimeMs() const { return StartupTimeMs; }
+
+    // Ассет реестра уровней (если не задан, используется последовательность по умолчанию)
+    UPROPERTY(EditDefaultsOnly, Category = "Уровни")
+    TSoftObjectPtr<UWLevelRegistry> LevelRegistryAsset;
     
     //----------------------------------------------------------------------------------------
     // АУДИО
@@ -86,6 +169,14 @@ public:
     // Получить аудио менеджер
     UFUNCTION(BlueprintCallable, Category = "Аудио")
     UWAudioManager* GetAudioManager() const { return AudioManager; }
+
+    // Микс и классы звука для громкости master/music/sfx
+    UPROPERTY(EditDefaultsOnly, Category = "Аудио")
+    FWAudioRouting AudioRouting;
+
+    // Ассеты HUD, загружаемые в фоне до входа на игровой уровень
+    UPROPERTY(EditDefaultsOnly, Category = "HUD")
+    FWHUDPreloadBundle HUDBundle;
     
     //----------------------------------------------------------------------------------------
     // РЕКОРДЫ
@@ -99,22 +190,61 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Рекорды")
     void UpdateBestScore(const FString& LevelName, int32 NewScore);
 
+    // То же по идентификатору уровня, без поиска по имени
+    UFUNCTION(BlueprintCallable, Category = "Рекорды")
+    void UpdateLevelBestTime(int32 LevelId, float NewTime);
+
+    UFUNCTION(BlueprintCallable, Category = "Рекорды")
+    void UpdateLevelBestScore(int32 LevelId, int32 NewScore);
+
+    // Разблокировать уровень в прогрессе профиля
+    UFUNCTION(BlueprintCallable, Category = "Рекорды")
+    void UnlockLevel(int32 LevelId);
+
 private:
     //----------------------------------------------------------------------------------------
     // ПРИВАТНЫЕ ПЕРЕМЕННЫЕ И МЕТОДЫ
     //----------------------------------------------------------------------------------------
     
-    // Текущий слот сохранения
+    // Текущий слот сохранения (последний выбранный профиль из индекса)
     UPROPERTY()
     FString CurrentSaveSlot;
+
+    // Индекс профилей
+    UPROPERTY()
+    UWProfileIndex* ProfileIndex;
+
+    // Профиль, загружаемый в фоне, и его история забегов
+    FString PendingProfileSlot;
+    bool bProfileLoadInFlight;
+    TFuture<void> ProfileLoad;
+
+    UPROPERTY()
+    UWRunHistory* PendingRunHistory;
     
     // Текущий объект сохранения
     UPROPERTY()
     UWTowerSaveGame* CurrentSaveGame;
+
+    // Сервис асинхронного сохранения
+    UPROPERTY()
+    UWSaveService* SaveService;
+
+    // Журнал изменений прогресса (дописывается вместо перезаписи всего сохранения)
+    UPROPERTY()
+    UWSaveJournal* SaveJournal;
+
+    // История забегов текущего профиля
+    UPROPERTY()
+    UWRunHistory* RunHistory;
     
     // Конфигурация игры
     UPROPERTY()
     UWTowerGameConfig* GameConfig;
+
+    // Сервис загрузки, кэширования и отслеживания настроек
+    UPROPERTY()
+    UWConfigService* ConfigService;
     
     // Аудио менеджер
     UPROPERTY()
@@ -126,16 +256,43 @@ private:
     // Путь к файлу настроек
     FString ConfigFilePath;
     
-    // Последовательность уровней в игре
+    // Реестр уровней (последовательность, идентификаторы, карты)
+    UPROPERTY()
+    UWLevelRegistry* LevelRegistry;
+
+    // Сервис предзагрузки и переходов между уровнями
     UPROPERTY()
-    TArray<FString> LevelSequence;
+    UWLevelTransitionService* TransitionService;
     
-    // Текущий индекс уровня
+    // Текущий индекс уровня в последовательности
     int32 CurrentLevelIndex;
+
+    // Время запуска (мс)
+    float StartupTimeMs;
     
-    // Инициализация настроек игры
-    void InitializeGameConfig();
+    // Инициализация настроек игры из уже прочитанных файлов;
+    // возвращает false, если применены настройки по умолчанию и их нужно записать
+    bool InitializeGameConfig(const FWConfigReadResult& ConfigRead);
+
+    // Принять загруженное сохранение или создать новое
+    void ApplyLoadedSaveGame(UWTowerSaveGame* LoadedSave);
+
+    // Слот профиля прочитан в фоне (игровой поток)
+    void OnProfileSlotRead(const FString& SlotName, bool bRead, const TArray<uint8>& Payload);
+
+    // Сделать слот текущим и запомнить его в индексе
+    void SwitchToSlot(const FString& SlotName);
+
+    // Обновить заголовок текущего профиля после записи слота
+    UFUNCTION()
+    void OnSlotSaved(const FString& SlotName, bool bSuccess);
+
+    // Обновить заголовок профиля после дозаписи журнала (индекс пишется с задержкой)
+    void OnJournalFlushed(const FString& SlotName, UWTowerSaveGame* FlushedSave);
+
+    // Количество уровней с прогрессом (без меню)
+    int32 GetNumPlayableLevels() const;
     
-    // Инициализация последовательности уровней
+    // Инициализация реестра уровней
     void InitializeLevelSequence();
 };
\ No newline at end of file
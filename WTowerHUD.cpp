@@ -2,6 +2,11 @@
 #include "WTowerHUDWidget.h"
 #include "Blueprint/UserWidget.h"
 #include "Kismet/GameplayStatics.h"
+#include "Engine/Engine.h"
+#include "Misc/App.h"
+#include "Engine/AssetManager.h"
+#include "WTowerGameInstance.h"
+#include "WTowerMemory.h"
 
 AWTowerHUD::AWTowerHUD()
 {
@@ -12,26 +17,85 @@ void AWTowerHUD::BeginPlay()
 {
     Super::BeginPlay();
 
-    // Проверка, установлен ли класс виджета
+    // Класс, заданный напрямую, уже загружен вместе с HUD
+    if (HUDWidgetClass)
+    {
+        CreateHUDWidget();
+        return;
+    }
+
+    // Набор HUD загружается в фоне во время перехода; если он готов, виджет создается сразу
+    const UWTowerGameInstance* GameInstance = GetGameInstance<UWTowerGameInstance>();
+    const FWHUDPreloadBundle Bundle = GameInstance ? GameInstance->HUDBundle : FWHUDPreloadBundle();
+
+    HUDBundleRequestTime = FPlatformTime::Seconds();
+    HUDBundleHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(Bundle.GetAssetPaths(),
+        FStreamableDelegate::CreateUObject(this, &AWTowerHUD::OnHUDBundleLoaded),
+        FStreamableManager::AsyncLoadHighPriority);
+}
+
+void AWTowerHUD::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (HUDBundleHandle.IsValid())
+    {
+        HUDBundleHandle->ReleaseHandle();
+        HUDBundleHandle.Reset();
+    }
+
+    Super::EndPlay(EndPlayReason);
+}
+
+void AWTowerHUD::OnHUDBundleLoaded()
+{
+    const UWTowerGameInstance* GameInstance = GetGameInstance<UWTowerGameInstance>();
+    const FWHUDPreloadBundle Bundle = GameInstance ? GameInstance->HUDBundle : FWHUDPreloadBundle();
+
+    HUDWidgetClass = Bundle.WidgetClass.Get();
     if (!HUDWidgetClass)
     {
-        // Загружаем класс виджета программно
-        HUDWidgetClass = LoadClass<UUserWidget>(nullptr, TEXT("/Game/Blueprints/Menu/WBP_GameHUD.WBP_GameHUD_C"));
+        UE_LOG(LogTemp, Warning, TEXT("WTowerHUD: HUD widget class %s failed to load"), *Bundle.WidgetClass.ToString());
+        return;
     }
 
-    if (HUDWidgetClass)
+    const double WaitMs = (FPlatformTime::Seconds() - HUDBundleRequestTime) * 1000.0;
+    UE_LOG(LogTemp, Log, TEXT("WTowerHUD: HUD bundle ready after %.1f ms"), WaitMs);
+
+    CreateHUDWidget();
+    if (CurrentHUDWidget)
+    {
+        CurrentHUDWidget->AddPowerUpIcons(Bundle.PowerUpIcons);
+    }
+}
+
+void AWTowerHUD::CreateHUDWidget()
+{
+    // Создаем и добавляем виджет
+    APlayerController* PC = GetWorld()->GetFirstPlayerController();
+    if (!PC || CurrentHUDWidget)
+        return;
+
+    LLM_SCOPE_BYTAG(Tower_HUD);
+
+    CurrentHUDWidget = CreateWidget<UWTowerHUDWidget>(PC, HUDWidgetClass);
+    if (CurrentHUDWidget)
+    {
+        CurrentHUDWidget->AddToViewport(0);
+    }
+}
+
+void AWTowerHUD::DrawHUD()
+{
+    Super::DrawHUD();
+
+    // Выключенный оверлей ничего не замеряет и не рисует
+    if (!FWTowerPerfOverlay::IsEnabled())
     {
-        // Создаем и добавляем виджет
-        APlayerController* PC = GetWorld()->GetFirstPlayerController();
-        if (PC)
-        {
-            CurrentHUDWidget = CreateWidget<UWTowerHUDWidget>(PC, HUDWidgetClass);
-            if (CurrentHUDWidget)
-            {
-                CurrentHUDWidget->AddToViewport(0);
-            }
-        }
+        FWTowerTickCosts::bEnabled = false;
+        return;
     }
+
+    PerfOverlay.Tick(GetWorld(), FApp::GetDeltaTime());
+    PerfOverlay.Draw(Canvas, GEngine->GetSmallFont(), FVector2D(16.0f, 16.0f));
 }
 
 void AWTowerHUD::ShowHUD()
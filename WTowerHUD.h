@@ -4,6 +4,8 @@
 #include "GameFramework/HUD.h" 
 #include "Blueprint/UserWidget.h"
 #include "BasePowerUp.h" // Добавляем заголовок для типов усилений
+#include "WTowerPerfOverlay.h"
+#include "Engine/StreamableManager.h"
 #include "WTowerHUD.generated.h"
 
 class UUserWidget;
@@ -24,6 +26,10 @@ public:
 protected:
     // Вызывается при начале игры
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+    // Отрисовка поверх кадра (оверлей производительности)
+    virtual void DrawHUD() override;
 
 public:
     // Основной виджет HUD
@@ -42,4 +48,17 @@ public:
     // Методы для отображения усилений
     void ShowPowerUp(EPowerUpType PowerUpType, float Duration);
     void HidePowerUp(EPowerUpType PowerUpType);
+
+private:
+    // Загрузка набора ассетов HUD (если класс виджета не задан напрямую)
+    TSharedPtr<FStreamableHandle> HUDBundleHandle;
+    double HUDBundleRequestTime = 0.0;
+
+    void OnHUDBundleLoaded();
+
+    // Создать виджет из HUDWidgetClass и добавить на экран
+    void CreateHUDWidget();
+
+    // Оверлей производительности (Tower.PerfOverlay)
+    FWTowerPerfOverlay PerfOverlay;
 };
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PowerUpComponent.h"
+#include "WTowerHUDBundle.generated.h"
+
+class UUserWidget;
+class UTexture2D;
+class UFont;
+
+/**
+ * Ассеты HUD, загружаемые в фоне во время перехода на игровой уровень:
+ * класс виджета, иконки усилений и шрифты. HUD создается, как только набор готов
+ */
+USTRUCT(BlueprintType)
+struct FWHUDPreloadBundle
+{
+    GENERATED_BODY()
+
+    // Класс виджета HUD
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "HUD")
+    TSoftClassPtr<UUserWidget> WidgetClass;
+
+    // Иконки усилений (используются для типов, иконки которых не заданы в виджете)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "HUD")
+    TMap<EPowerUpType, TSoftObjectPtr<UTexture2D>> PowerUpIcons;
+
+    // Шрифты HUD
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "HUD")
+    TArray<TSoftObjectPtr<UFont>> Fonts;
+
+    FWHUDPreloadBundle()
+        : WidgetClass(FSoftObjectPath(TEXT("/Game/Blueprints/Menu/WBP_GameHUD.WBP_GameHUD_C")))
+    {
+    }
+
+    // Пути всех ассетов набора
+    TArray<FSoftObjectPath> GetAssetPaths() const
+    {
+        TArray<FSoftObjectPath> Paths;
+        if (!WidgetClass.IsNull())
+        {
+            Paths.Add(WidgetClass.ToSoftObjectPath());
+        }
+        for (const TPair<EPowerUpType, TSoftObjectPtr<UTexture2D>>& Icon : PowerUpIcons)
+        {
+            if (!Icon.Value.IsNull())
+            {
+                Paths.AddUnique(Icon.Value.ToSoftObjectPath());
+            }
+        }
+        for (const TSoftObjectPtr<UFont>& Font : Fonts)
+        {
+            if (!Font.IsNull())
+            {
+                Paths.AddUnique(Font.ToSoftObjectPath());
+            }
+        }
+        return Paths;
+    }
+};
@@ -0,0 +1,141 @@
+#include "WTowerHUDTextFormatter.h"
+
+FWTowerHUDTextFormatter::FWTowerHUDTextFormatter()
+    : ScoreLine(NSLOCTEXT("WTowerHUD", "ScoreFormat", "Счет: {0}"))
+    , TimeLine(NSLOCTEXT("WTowerHUD", "TimeFormat", "Время: {0}"))
+    , HeightLine(NSLOCTEXT("WTowerHUD", "HeightFormat", "Высота: {0} м"))
+    , MaxHeightLine(NSLOCTEXT("WTowerHUD", "MaxHeightFormat", "Макс. высота: {0} м"))
+    , Length(0)
+{
+    Buffer[0] = TEXT('\0');
+    Arguments.Reserve(1);
+}
+
+//----------------------------------------------------------------------------------------
+// ТЕКСТЫ HUD
+//----------------------------------------------------------------------------------------
+
+FText FWTowerHUDTextFormatter::FormatScore(int32 Score)
+{
+    if (ScoreLine.IsCached(Score))
+        return ScoreLine.Text;
+
+    Reset();
+    AppendInt(Score);
+    return BuildLine(ScoreLine, Score);
+}
+
+FText FWTowerHUDTextFormatter::FormatTime(int32 TotalSeconds)
+{
+    if (TimeLine.IsCached(TotalSeconds))
+        return TimeLine.Text;
+
+    Reset();
+    AppendTime(TotalSeconds);
+    return BuildLine(TimeLine, TotalSeconds);
+}
+
+FText FWTowerHUDTextFormatter::FormatHeight(int32 Decimeters)
+{
+    return FormatMeters(HeightLine, Decimeters);
+}
+
+FText FWTowerHUDTextFormatter::FormatMaxHeight(int32 Decimeters)
+{
+    return FormatMeters(MaxHeightLine, Decimeters);
+}
+
+FText FWTowerHUDTextFormatter::FormatMeters(FLine& Line, int32 Decimeters)
+{
+    if (Line.IsCached(Decimeters))
+        return Line.Text;
+
+    Reset();
+    AppendDecimeters(Decimeters);
+    return BuildLine(Line, Decimeters);
+}
+
+FStringView FWTowerHUDTextFormatter::WriteTime(int32 TotalSeconds)
+{
+    Reset();
+    AppendTime(TotalSeconds);
+    return GetView();
+}
+
+FText FWTowerHUDTextFormatter::BuildLine(FLine& Line, int32 Value)
+{
+    // Выделения памяти только здесь, при изменении значения: строка числа и история
+    // форматированного текста, которая связывает его с шаблоном для смены языка
+    Arguments.Reset();
+    Arguments.Emplace(FText::AsCultureInvariant(FString(GetView())));
+
+    Line.Text = FText::Format(Line.Format, Arguments);
+    Line.Value = Value;
+    Line.bHasText = true;
+    return Line.Text;
+}
+
+//----------------------------------------------------------------------------------------
+// БУФЕР
+//----------------------------------------------------------------------------------------
+
+void FWTowerHUDTextFormatter::AppendChar(TCHAR Char)
+{
+    if (Length < BufferSize - 1)
+    {
+        Buffer[Length++] = Char;
+        Buffer[Length] = TEXT('\0');
+    }
+}
+
+void FWTowerHUDTextFormatter::AppendInt(int32 Value, int32 MinDigits)
+{
+    // Цифры собираются с конца во временном буфере; int64 - чтобы MIN_int32 не переполнялся
+    int64 Magnitude = Value;
+    if (Magnitude < 0)
+    {
+        AppendChar(TEXT('-'));
+        Magnitude = -Magnitude;
+    }
+
+    TCHAR Digits[16];
+    int32 NumDigits = 0;
+    do
+    {
+        Digits[NumDigits++] = static_cast<TCHAR>(TEXT('0') + Magnitude % 10);
+        Magnitude /= 10;
+    } while (Magnitude > 0);
+
+    while (NumDigits < MinDigits && NumDigits < UE_ARRAY_COUNT(Digits))
+    {
+        Digits[NumDigits++] = TEXT('0');
+    }
+
+    while (NumDigits > 0)
+    {
+        AppendChar(Digits[--NumDigits]);
+    }
+}
+
+void FWTowerHUDTextFormatter::AppendDecimeters(int32 Decimeters)
+{
+    // Знак пишется отдельно: для -0.5 м целая часть равна нулю
+    int64 Magnitude = Decimeters;
+    if (Magnitude < 0)
+    {
+        AppendChar(TEXT('-'));
+        Magnitude = -Magnitude;
+    }
+
+    AppendInt(static_cast<int32>(Magnitude / 10));
+    AppendChar(TEXT('.'));
+    AppendChar(static_cast<TCHAR>(TEXT('0') + Magnitude % 10));
+}
+
+void FWTowerHUDTextFormatter::AppendTime(int32 TotalSeconds)
+{
+    TotalSeconds = FMath::Max(TotalSeconds, 0);
+    AppendInt(TotalSeconds / 60, 2);
+    AppendChar(TEXT(':'));
+    AppendInt(TotalSeconds % 60, 2);
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Форматирование чисел для HUD без printf.
+ * Каждая строка HUD - локализуемый шаблон FTextFormat, разобранный один раз,
+ * поэтому переводчик может менять порядок подписи и числа. Число пишется во встроенный
+ * буфер фиксированного размера и передается в шаблон как культурно-независимый аргумент.
+ * Готовый текст строки кэшируется: при неизменном значении память не выделяется,
+ * а при смене языка текст перестраивается по шаблону.
+ */
+class WTOWER_API FWTowerHUDTextFormatter
+{
+public:
+    FWTowerHUDTextFormatter();
+
+    // "Счет: 1234"
+    FText FormatScore(int32 Score);
+
+    // "Время: MM:SS"
+    FText FormatTime(int32 TotalSeconds);
+
+    // "Высота: 12.3 м" (высота в дециметрах)
+    FText FormatHeight(int32 Decimeters);
+
+    // "Макс. высота: 12.3 м" (высота в дециметрах)
+    FText FormatMaxHeight(int32 Decimeters);
+
+    // Время в виде MM:SS (представление действительно до следующего вызова)
+    FStringView WriteTime(int32 TotalSeconds);
+
+    // Текущее содержимое буфера
+    FStringView GetView() const { return FStringView(Buffer, Length); }
+
+private:
+    static constexpr int32 BufferSize = 64;
+
+    // Строка HUD: шаблон и последний построенный по нему текст
+    struct FLine
+    {
+        FTextFormat Format;
+        FText Text;
+        int32 Value = 0;
+        bool bHasText = false;
+
+        explicit FLine(const FText& InPattern)
+            : Format(InPattern)
+        {
+        }
+
+        bool IsCached(int32 InValue) const { return bHasText && Value == InValue; }
+    };
+
+    FLine ScoreLine;
+    FLine TimeLine;
+    FLine HeightLine;
+    FLine MaxHeightLine;
+
+    // Аргументы шаблона (массив переиспользуется между вызовами)
+    FFormatOrderedArguments Arguments;
+
+    TCHAR Buffer[BufferSize];
+    int32 Length;
+
+    void Reset() { Length = 0; }
+    void AppendChar(TCHAR Char);
+
+    // Целое число, дополненное нулями слева до MinDigits цифр
+    void AppendInt(int32 Value, int32 MinDigits = 1);
+
+    // Дециметры в виде метров с одним знаком после точки
+    void AppendDecimeters(int32 Decimeters);
+
+    void AppendTime(int32 TotalSeconds);
+
+    FText FormatMeters(FLine& Line, int32 Decimeters);
+
+    // Подставить содержимое буфера в шаблон строки и запомнить результат
+    FText BuildLine(FLine& Line, int32 Value);
+};
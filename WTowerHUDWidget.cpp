@@ -1,10 +1,14 @@
 #include "WTowerHUDWidget.h"
 #include "WTowerGameState.h"
+#include "Gameplay/WTowerRunSubsystem.h"
+#include "WTowerStats.h"
+#include "WTowerMemory.h"
 #include "Components/TextBlock.h"
 #include "Components/HorizontalBox.h"
 #include "Components/ProgressBar.h"
 #include "Components/Image.h"
 #include "Components/Border.h"
+#include "Components/InvalidationBox.h"
 #include "Blueprint/WidgetTree.h"
 #include "Kismet/GameplayStatics.h"
 #include <Components/VerticalBox.h>
@@ -21,15 +25,49 @@ void UWTowerHUDWidget::NativeConstruct()
        
     }
 
+    // Индикаторы усилений создаются заранее, во время игры только показываются и скрываются
+    if (PowerUpSlots.Num() == 0)
+    {
+        BuildPowerUpSlots();
+    }
+
+    // Статистика меняется редко: панель кэширует ее, пока текст не изменится
+    if (StatsInvalidationBox)
+    {
+        StatsInvalidationBox->SetCanCache(true);
+    }
+
     // Инициализируем отображаемые значения
+    InvalidateStats();
     UpdateStats();
+
+    // Высота не опрашивается: тексты меняются по событию подсистемы забега
+    if (UWTowerRunSubsystem* Run = UWTowerRunSubsystem::Get(this))
+    {
+        HeightChangedHandle = Run->OnHeightChanged.AddUObject(this, &UWTowerHUDWidget::OnHeightChanged);
+        BoundRun = Run;
+        OnHeightChanged(Run->GetPublishedHeight(), Run->GetMaxHeight(), false);
+    }
+}
+
+void UWTowerHUDWidget::NativeDestruct()
+{
+    if (UWTowerRunSubsystem* Run = BoundRun.Get())
+    {
+        Run->OnHeightChanged.Remove(HeightChangedHandle);
+    }
+    BoundRun = nullptr;
+    HeightChangedHandle.Reset();
+
+    Super::NativeDestruct();
 }
 
 void UWTowerHUDWidget::NativeTick(const FGeometry& MyGeometry, float InDeltaTime)
 {
+    WTOWER_SCOPE_TICK(STAT_TowerHUDTick, HUD);
     Super::NativeTick(MyGeometry, InDeltaTime);
 
-    // Обновляем статистику каждый кадр
+    // Проверяем счет и время каждый кадр, тексты меняются только при изменении значений
     UpdateStats();
 
     // Обновляем таймеры усилений
@@ -38,7 +76,16 @@ void UWTowerHUDWidget::NativeTick(const FGeometry& MyGeometry, float InDeltaTime
 
 AWTowerGameState* UWTowerHUDWidget::GetWTowerGameState() const
 {
-    return Cast<AWTowerGameState>(UGameplayStatics::GetGameState(GetWorld()));
+    UWTowerRunSubsystem* Run = UWTowerRunSubsystem::Get(this);
+    return Run ? Run->GetTowerGameState() : nullptr;
+}
+
+void UWTowerHUDWidget::InvalidateStats()
+{
+    DisplayedScore.Reset();
+    DisplayedSeconds.Reset();
+    DisplayedHeight.Reset();
+    DisplayedMaxHeight.Reset();
 }
 
 void UWTowerHUDWidget::UpdateStats()
@@ -47,131 +94,170 @@ void UWTowerHUDWidget::UpdateStats()
     if (!GameState)
         return;
 
+    ApplyStats(GameState->GetScore(), FMath::Max(FMath::FloorToInt(GameState->GetGameTime()), 0));
+}
+
+void UWTowerHUDWidget::ApplyStats(int32 Score, int32 Seconds)
+{
+    // Значения сравниваются с точностью отображения; SetText вызывает пересчет
+    // разметки, поэтому без изменений текст не трогаем
+
     // Обновляем счет
-    if (ScoreText)
+    if (ScoreText && DisplayedScore != Score)
     {
-        ScoreText->SetText(FText::FromString(FString::Printf(TEXT("Счет: %d"), GameState->GetScore())));
+        DisplayedScore = Score;
+        ScoreText->SetText(TextFormatter.FormatScore(Score));
     }
 
     // Обновляем время
-    if (TimeText)
+    if (TimeText && DisplayedSeconds != Seconds)
     {
-        TimeText->SetText(FText::FromString(FString::Printf(TEXT("Время: %s"), *FormatTime(GameState->GetGameTime()))));
+        DisplayedSeconds = Seconds;
+        TimeText->SetText(TextFormatter.FormatTime(Seconds));
     }
+}
+
+void UWTowerHUDWidget::OnHeightChanged(float CurrentHeight, float MaxHeight, bool bNewMax)
+{
+    const int32 Height = FMath::RoundToInt(CurrentHeight / 10.0f);
+    const int32 MaxHeightDm = FMath::RoundToInt(MaxHeight / 10.0f);
 
     // Обновляем текущую высоту
-    if (HeightText)
+    if (HeightText && DisplayedHeight != Height)
     {
-        HeightText->SetText(FText::FromString(FString::Printf(TEXT("Высота: %.1f м"), GameState->GetPlayerCurrentHeight() / 100.0f)));
+        DisplayedHeight = Height;
+        HeightText->SetText(TextFormatter.FormatHeight(Height));
     }
 
     // Обновляем максимальную высоту
-    if (MaxHeightText)
+    if (MaxHeightText && DisplayedMaxHeight != MaxHeightDm)
     {
-        MaxHeightText->SetText(FText::FromString(FString::Printf(TEXT("Макс. высота: %.1f м"), GameState->GetPlayerMaxHeight() / 100.0f)));
+        DisplayedMaxHeight = MaxHeightDm;
+        MaxHeightText->SetText(TextFormatter.FormatMaxHeight(MaxHeightDm));
     }
 }
 
 FString UWTowerHUDWidget::FormatTime(float TimeInSeconds) const
 {
-    int32 Minutes = FMath::FloorToInt(TimeInSeconds / 60.0f);
-    int32 Seconds = FMath::FloorToInt(TimeInSeconds) % 60;
-
-    return FString::Printf(TEXT("%02d:%02d"), Minutes, Seconds);
+    return FString(TextFormatter.WriteTime(FMath::FloorToInt(TimeInSeconds)));
 }
 
 void UWTowerHUDWidget::ShowPowerUp(EPowerUpType PowerUpType, float Duration)
 {
-    // Проверяем, отображается ли уже это усиление
-    if (ActivePowerUps.Contains(PowerUpType))
-    {
-        // Обновляем время существующего усиления
-        FActivePowerUp& PowerUp = ActivePowerUps[PowerUpType];
-        PowerUp.RemainingTime = Duration;
-        PowerUp.TotalDuration = Duration;
+    const int32 SlotIndex = static_cast<int32>(PowerUpType);
+    if (!PowerUpSlots.IsValidIndex(SlotIndex) || !PowerUpSlots[SlotIndex].Root)
+        return;
 
-        // Сбрасываем индикатор прогресса
-        if (PowerUp.TimeBar)
-        {
-            PowerUp.TimeBar->SetPercent(1.0f);
-        }
+    // Повторный подбор того же усиления только перезапускает таймер
+    FPowerUpSlot& Slot = PowerUpSlots[SlotIndex];
+    Slot.RemainingTime = Duration;
+    Slot.TotalDuration = Duration;
+
+    // Иконка могла быть задана после конструирования виджета
+    UTexture2D* const* IconTexture = PowerUpIcons.Find(PowerUpType);
+    if (IconTexture && *IconTexture && Slot.Icon->GetBrush().GetResourceObject() != *IconTexture)
+    {
+        Slot.Icon->SetBrushFromTexture(*IconTexture, true);
     }
-    else
+
+    // Сбрасываем индикатор прогресса
+    Slot.TimeBar->SetPercent(1.0f);
+
+    if (!Slot.bActive)
     {
-        // Создаем новый элемент для отображения усиления
-        CreatePowerUpElement(PowerUpType, Duration);
+        Slot.bActive = true;
+        Slot.Root->SetVisibility(ESlateVisibility::HitTestInvisible);
     }
 }
 
 void UWTowerHUDWidget::HidePowerUp(EPowerUpType PowerUpType)
 {
-    // Проверяем, есть ли такое усиление
-    if (ActivePowerUps.Contains(PowerUpType))
-    {
-        FActivePowerUp PowerUp = ActivePowerUps[PowerUpType];
-
-        // Удаляем визуальные элементы
-        if (PowerUpsContainer)
-        {
-            if (PowerUp.Icon && PowerUp.Icon->GetParent())
-            {
-                PowerUpsContainer->RemoveChild(PowerUp.Icon->GetParent());
-            }
-        }
+    const int32 SlotIndex = static_cast<int32>(PowerUpType);
+    if (!PowerUpSlots.IsValidIndex(SlotIndex))
+        return;
 
-        // Удаляем из списка активных усилений
-        ActivePowerUps.Remove(PowerUpType);
+    // Скрытый индикатор остается в контейнере и не занимает места
+    FPowerUpSlot& Slot = PowerUpSlots[SlotIndex];
+    if (Slot.bActive && Slot.Root)
+    {
+        Slot.bActive = false;
+        Slot.Root->SetVisibility(ESlateVisibility::Collapsed);
     }
 }
 
 void UWTowerHUDWidget::UpdatePowerUpTimers(float DeltaTime)
 {
-    // Временный список для хранения усилений, которые нужно удалить
-    TArray<EPowerUpType> PowerUpsToRemove;
-
     // Обновляем таймеры всех активных усилений
-    for (auto& Pair : ActivePowerUps)
+    for (int32 SlotIndex = 0; SlotIndex < PowerUpSlots.Num(); ++SlotIndex)
     {
-        EPowerUpType PowerUpType = Pair.Key;
-        FActivePowerUp& PowerUp = Pair.Value;
+        FPowerUpSlot& Slot = PowerUpSlots[SlotIndex];
+        if (!Slot.bActive)
+            continue;
 
         // Уменьшаем оставшееся время
-        PowerUp.RemainingTime -= DeltaTime;
+        Slot.RemainingTime -= DeltaTime;
 
-        // Обновляем индикатор прогресса
-        if (PowerUp.TimeBar)
+        // Если время истекло, скрываем индикатор
+        if (Slot.RemainingTime <= 0.0f)
         {
-            float Percent = FMath::Clamp(PowerUp.RemainingTime / PowerUp.TotalDuration, 0.0f, 1.0f);
-            PowerUp.TimeBar->SetPercent(Percent);
+            HidePowerUp(static_cast<EPowerUpType>(SlotIndex));
+            continue;
         }
 
-        // Если время истекло, добавляем в список для удаления
-        if (PowerUp.RemainingTime <= 0.0f)
-        {
-            PowerUpsToRemove.Add(PowerUpType);
-        }
+        // Обновляем индикатор прогресса
+        const float Percent = Slot.TotalDuration > 0.0f ? FMath::Clamp(Slot.RemainingTime / Slot.TotalDuration, 0.0f, 1.0f) : 0.0f;
+        Slot.TimeBar->SetPercent(Percent);
     }
+}
 
-    // Удаляем усиления с истекшим временем
-    for (EPowerUpType PowerUpType : PowerUpsToRemove)
+void UWTowerHUDWidget::AddPowerUpIcons(const TMap<EPowerUpType, TSoftObjectPtr<UTexture2D>>& Icons)
+{
+    // Иконки, заданные в самом виджете, имеют приоритет
+    for (const TPair<EPowerUpType, TSoftObjectPtr<UTexture2D>>& Icon : Icons)
     {
-        HidePowerUp(PowerUpType);
+        UTexture2D* Texture = Icon.Value.Get();
+        if (Texture && !PowerUpIcons.Contains(Icon.Key))
+        {
+            PowerUpIcons.Add(Icon.Key, Texture);
+        }
     }
 }
 
-void UWTowerHUDWidget::CreatePowerUpElement(EPowerUpType PowerUpType, float Duration)
+void UWTowerHUDWidget::BuildPowerUpSlots()
 {
     if (!PowerUpsContainer || !WidgetTree)
         return;
 
+    LLM_SCOPE_BYTAG(Tower_HUD);
+
+    // Последнее значение перечисления - служебное _MAX
+    const UEnum* PowerUpEnum = StaticEnum<EPowerUpType>();
+    const int32 NumTypes = PowerUpEnum->NumEnums() - 1;
+    PowerUpSlots.SetNum(NumTypes);
+
+    for (int32 Index = 0; Index < NumTypes; ++Index)
+    {
+        const EPowerUpType PowerUpType = static_cast<EPowerUpType>(PowerUpEnum->GetValueByIndex(Index));
+        if (PowerUpType == EPowerUpType::None)
+            continue;
+
+        PowerUpSlots[static_cast<int32>(PowerUpType)] = CreatePowerUpElement(PowerUpType);
+    }
+}
+
+UWTowerHUDWidget::FPowerUpSlot UWTowerHUDWidget::CreatePowerUpElement(EPowerUpType PowerUpType)
+{
+    FPowerUpSlot Slot;
+
     // Создаем контейнер для иконки и индикатора прогресса
     UBorder* Border = WidgetTree->ConstructWidget<UBorder>();
     if (!Border)
-        return;
+        return Slot;
 
     // Настраиваем стиль рамки
     Border->SetBrushColor(FLinearColor(0.1f, 0.1f, 0.1f, 0.7f));
     Border->SetPadding(FMargin(5.0f));
+    Border->SetVisibility(ESlateVisibility::Collapsed);
     PowerUpsContainer->AddChild(Border);
 
     // Создаем вертикальный контейнер для размещения иконки и прогресс-бара
@@ -205,12 +291,8 @@ void UWTowerHUDWidget::CreatePowerUpElement(EPowerUpType PowerUpType, float Dura
     }
     TimeBar->SetPercent(1.0f);
 
-    // Сохраняем информацию об усилении
-    FActivePowerUp PowerUp;
-    PowerUp.Icon = Icon;
-    PowerUp.TimeBar = TimeBar;
-    PowerUp.RemainingTime = Duration;
-    PowerUp.TotalDuration = Duration;
-
-    ActivePowerUps.Add(PowerUpType, PowerUp);
+    Slot.Root = Border;
+    Slot.Icon = Icon;
+    Slot.TimeBar = TimeBar;
+    return Slot;
 }
\ No newline at end of file
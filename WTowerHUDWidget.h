@@ -4,12 +4,16 @@
 #include "Blueprint/UserWidget.h"
 #include "Components/TextBlock.h"
 #include "BasePowerUp.h" // Добавляем доступ к типам усилений
+#include "WTowerHUDTextFormatter.h"
 #include "WTowerHUDWidget.generated.h"
 
 class AWTowerGameState;
+class UWTowerRunSubsystem;
 class UProgressBar;
 class UHorizontalBox;
 class UImage;
+class UInvalidationBox;
+class UWidget;
 
 /**
  * Виджет для отображения игровой статистики и активных усилений
@@ -21,14 +25,22 @@ class WTOWER_API UWTowerHUDWidget : public UUserWidget
 
 public:
     virtual void NativeConstruct() override;
+    virtual void NativeDestruct() override;
     virtual void NativeTick(const FGeometry& MyGeometry, float InDeltaTime) override;
 
     // Получить GameState
     AWTowerGameState* GetWTowerGameState() const;
 
-    // Обновить все отображаемые значения
+    // Обновить отображаемые счет и время; текст меняется только у изменившихся.
+    // Высота обновляется по событию подсистемы забега
     void UpdateStats();
 
+    // Показать счет и время (целые секунды); текст меняется только у изменившихся
+    void ApplyStats(int32 Score, int32 Seconds);
+
+    // Сбросить запомненные значения, чтобы следующее обновление перерисовало все тексты
+    void InvalidateStats();
+
     // Форматировать время в MM:SS
     FString FormatTime(float TimeInSeconds) const;
 
@@ -37,6 +49,9 @@ public:
     void HidePowerUp(EPowerUpType PowerUpType);
     void UpdatePowerUpTimers(float DeltaTime);
 
+    // Дополнить иконки усилений загруженными иконками набора HUD (применяются при показе усиления)
+    void AddPowerUpIcons(const TMap<EPowerUpType, TSoftObjectPtr<UTexture2D>>& Icons);
+
 protected:
     // Текстовые блоки для отображения статистики
     UPROPERTY(meta = (BindWidget))
@@ -51,6 +66,11 @@ protected:
     UPROPERTY(meta = (BindWidget))
     UTextBlock* MaxHeightText;
 
+    // Необязательная панель кэширования вокруг статистики: без изменений текста
+    // ее содержимое не пересчитывается и не перерисовывается заново
+    UPROPERTY(meta = (BindWidgetOptional))
+    UInvalidationBox* StatsInvalidationBox;
+
     // Контейнер для усилений
     UPROPERTY(meta = (BindWidget))
     UHorizontalBox* PowerUpsContainer;
@@ -64,18 +84,41 @@ protected:
     TMap<EPowerUpType, FLinearColor> PowerUpColors;
 
 private:
-    // Структура для хранения информации об активных усилениях
-    struct FActivePowerUp
+    // Последние отображенные значения в единицах отображения
+    // (очки, целые секунды, дециметры высоты); без значения - текст еще не задан
+    TOptional<int32> DisplayedScore;
+    TOptional<int32> DisplayedSeconds;
+    TOptional<int32> DisplayedHeight;
+    TOptional<int32> DisplayedMaxHeight;
+
+    // Форматирование текстов статистики без printf и временных строк
+    // (изменяемое: буфер и кэш строк не входят в логическое состояние виджета)
+    mutable FWTowerHUDTextFormatter TextFormatter;
+
+    // Подписка на опубликованную высоту забега
+    TWeakObjectPtr<UWTowerRunSubsystem> BoundRun;
+    FDelegateHandle HeightChangedHandle;
+
+    // Обновить тексты высоты по событию (не чаще шага публикации высоты)
+    void OnHeightChanged(float CurrentHeight, float MaxHeight, bool bNewMax);
+
+    // Заранее созданный индикатор усиления; виджеты принадлежат WidgetTree
+    struct FPowerUpSlot
     {
-        UImage* Icon;
-        UProgressBar* TimeBar;
-        float RemainingTime;
-        float TotalDuration;
+        UWidget* Root = nullptr;
+        UImage* Icon = nullptr;
+        UProgressBar* TimeBar = nullptr;
+        float RemainingTime = 0.0f;
+        float TotalDuration = 0.0f;
+        bool bActive = false;
     };
 
-    // Активные усиления
-    TMap<EPowerUpType, FActivePowerUp> ActivePowerUps;
+    // Индикаторы по типам усилений (индекс = EPowerUpType)
+    TArray<FPowerUpSlot> PowerUpSlots;
+
+    // Создать скрытые индикаторы для всех типов усилений (один раз при конструировании)
+    void BuildPowerUpSlots();
 
-    // Создает новый элемент для усиления
-    void CreatePowerUpElement(EPowerUpType PowerUpType, float Duration);
+    // Создает элемент индикатора для усиления
+    FPowerUpSlot CreatePowerUpElement(EPowerUpType PowerUpType);
 };
\ No newline at end of file
@@ -0,0 +1,107 @@
+#include "WTowerMemory.h"
+#include "WTowerHUDWidget.h"
+#include "DoodlePlatform.h"
+#include "PowerUpActor.h"
+#include "PowerUpComponent.h"
+#include "SaveGame/WTowerSaveGame.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/UObjectIterator.h"
+
+LLM_DEFINE_TAG(Tower_Platforms);
+LLM_DEFINE_TAG(Tower_PowerUps);
+LLM_DEFINE_TAG(Tower_HUD);
+LLM_DEFINE_TAG(Tower_Audio);
+LLM_DEFINE_TAG(Tower_Save);
+
+namespace
+{
+    // Количество живых объектов класса в мире (без шаблонов и архетипов);
+    // объекты вне мира, например сохранения, считаются при World == nullptr
+    template <typename T>
+    int32 CountObjectsInWorld(const UWorld* World)
+    {
+        int32 Count = 0;
+        for (TObjectIterator<T> It; It; ++It)
+        {
+            if (!It->IsTemplate() && It->GetWorld() == World)
+            {
+                ++Count;
+            }
+        }
+        return Count;
+    }
+
+    void DumpMemReport(UWorld* World)
+    {
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+        if (!FLowLevelMemTracker::IsEnabled())
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Tower.MemReport: Low Level Memory Tracker is off, run with -llm"));
+            return;
+        }
+
+        // Экземпляры, на которые делится память тега
+        int32 NumPlatforms = 0;
+        for (TActorIterator<ADoodlePlatform> It(World); It; ++It)
+        {
+            ++NumPlatforms;
+        }
+
+        struct FRow
+        {
+            const TCHAR* TagName;
+            // nullptr - память тега не делится на однотипные экземпляры
+            const TCHAR* InstanceName;
+            int32 Instances;
+        };
+
+        // Имя тега LLM получается из имени в LLM_DEFINE_TAG заменой '_' на '/'
+        const FRow Rows[] =
+        {
+            { TEXT("Tower/Platforms"), TEXT("platform"), NumPlatforms },
+            { TEXT("Tower/PowerUps"), TEXT("power-up"), CountObjectsInWorld<APowerUpActor>(World) + CountObjectsInWorld<UPowerUpComponent>(World) },
+            { TEXT("Tower/HUD"), TEXT("HUD widget"), CountObjectsInWorld<UWTowerHUDWidget>(World) },
+            // Тег охватывает менеджер, пул голосов, деки музыки и кэш звуков - общего экземпляра нет
+            { TEXT("Tower/Audio"), nullptr, 0 },
+            { TEXT("Tower/Save"), TEXT("save object"), CountObjectsInWorld<UWTowerSaveGame>(nullptr) },
+        };
+
+        FLowLevelMemTracker& Tracker = FLowLevelMemTracker::Get();
+        int64 TotalBytes = 0;
+
+        UE_LOG(LogTemp, Display, TEXT("Tower.MemReport: %-16s %12s %10s %14s"), TEXT("Tag"), TEXT("KB"), TEXT("Instances"), TEXT("KB/instance"));
+        for (const FRow& Row : Rows)
+        {
+            const int64 Bytes = Tracker.GetTagAmountForTracker(ELLMTracker::Default, FName(Row.TagName), ELLMTagSet::None);
+            TotalBytes += Bytes;
+
+            if (!Row.InstanceName)
+            {
+                UE_LOG(LogTemp, Display, TEXT("Tower.MemReport: %-16s %12.1f %10s %14s"),
+                    Row.TagName, Bytes / 1024.0, TEXT("-"), TEXT("-"));
+            }
+            else if (Row.Instances > 0)
+            {
+                UE_LOG(LogTemp, Display, TEXT("Tower.MemReport: %-16s %12.1f %10d %14.2f  (per %s)"),
+                    Row.TagName, Bytes / 1024.0, Row.Instances, Bytes / 1024.0 / Row.Instances, Row.InstanceName);
+            }
+            else
+            {
+                UE_LOG(LogTemp, Display, TEXT("Tower.MemReport: %-16s %12.1f %10d %14s"),
+                    Row.TagName, Bytes / 1024.0, 0, TEXT("-"));
+            }
+        }
+
+        UE_LOG(LogTemp, Display, TEXT("Tower.MemReport: %-16s %12.1f"), TEXT("Total"), TotalBytes / 1024.0);
+#else
+        UE_LOG(LogTemp, Warning, TEXT("Tower.MemReport: Low Level Memory Tracker is not compiled into this build"));
+#endif
+    }
+}
+
+static FAutoConsoleCommandWithWorld TowerMemReportCommand(
+    TEXT("Tower.MemReport"),
+    TEXT("Dump memory per Tower LLM tag (platforms, power-ups, HUD, audio, save) with per-instance averages where they apply. Requires -llm"),
+    FConsoleCommandWithWorldDelegate::CreateStatic(&DumpMemReport));
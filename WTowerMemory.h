@@ -0,0 +1,16 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
+
+/**
+ * Теги Low Level Memory Tracker для подсистем игры (запуск с -llm).
+ * Ставятся в местах выделения: создание акторов и компонентов, динамических
+ * материалов, виджетов и аудиокомпонентов, сериализация сохранений.
+ * Разбивку по тегам со средним на экземпляр выводит команда Tower.MemReport
+ */
+LLM_DECLARE_TAG_API(Tower_Platforms, WTOWER_API);
+LLM_DECLARE_TAG_API(Tower_PowerUps, WTOWER_API);
+LLM_DECLARE_TAG_API(Tower_HUD, WTOWER_API);
+LLM_DECLARE_TAG_API(Tower_Audio, WTOWER_API);
+LLM_DECLARE_TAG_API(Tower_Save, WTOWER_API);
@@ -0,0 +1,170 @@
+#include "WTowerPerfOverlay.h"
+#include "WTowerGameInstance.h"
+#include "DoodlePlatform.h"
+#include "PowerUpActor.h"
+#include "Audio/WAudioManager.h"
+#include "CanvasItem.h"
+#include "Engine/Canvas.h"
+#include "Engine/Font.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "RenderCore.h"
+
+static TAutoConsoleVariable<int32> CVarTowerPerfOverlay(
+    TEXT("Tower.PerfOverlay"),
+    0,
+    TEXT("Show the in-game performance overlay (0 - off, 1 - on)"),
+    ECVF_Default);
+
+namespace
+{
+    const TCHAR* const TickCostNames[] = { TEXT("Platforms"), TEXT("Power-ups"), TEXT("Player"), TEXT("HUD") };
+    static_assert(UE_ARRAY_COUNT(TickCostNames) == static_cast<int32>(EWTowerTickCost::Count), "Name every EWTowerTickCost");
+
+    // Масштаб графика: верхняя граница соответствует 33 мс (30 FPS)
+    constexpr float SparklineMaxMs = 33.3f;
+}
+
+FWTowerPerfOverlay::FWTowerPerfOverlay()
+    : HistoryHead(0)
+    , TimeSinceSample(SampleInterval)
+    , FramesSinceSample(0)
+{
+    FMemory::Memzero(FrameHistory);
+}
+
+bool FWTowerPerfOverlay::IsEnabled()
+{
+    return CVarTowerPerfOverlay.GetValueOnGameThread() != 0;
+}
+
+//----------------------------------------------------------------------------------------
+// ЗАМЕРЫ
+//----------------------------------------------------------------------------------------
+
+void FWTowerPerfOverlay::Tick(UWorld* World, float DeltaTime)
+{
+    // Замеры тиков включаются вместе с оверлеем; первый интервал после включения неполный
+    if (!FWTowerTickCosts::bEnabled)
+    {
+        FWTowerTickCosts::bEnabled = true;
+        FWTowerTickCosts::Reset();
+        FramesSinceSample = 0;
+    }
+
+    FrameHistory[HistoryHead] = DeltaTime * 1000.0f;
+    HistoryHead = (HistoryHead + 1) % HistorySize;
+
+    ++FramesSinceSample;
+    TimeSinceSample += DeltaTime;
+    if (TimeSinceSample >= SampleInterval)
+    {
+        Sample(World);
+        TimeSinceSample = 0.0f;
+        FramesSinceSample = 0;
+        FWTowerTickCosts::Reset();
+    }
+}
+
+void FWTowerPerfOverlay::Sample(UWorld* World)
+{
+    Lines.Reset();
+    if (!World)
+        return;
+
+    // Время потоков за последний кадр (обновляется движком, как в stat unit)
+    const float FrameMs = FrameHistory[(HistoryHead + HistorySize - 1) % HistorySize];
+    Lines.Add(FText::FromString(FString::Printf(TEXT("Frame %.2f ms  Game %.2f  Render %.2f  RHI %.2f"),
+        FrameMs,
+        FPlatformTime::ToMilliseconds(GGameThreadTime),
+        FPlatformTime::ToMilliseconds(GRenderThreadTime),
+        FPlatformTime::ToMilliseconds(GRHIThreadTime))));
+
+    // Объекты считаются обходом мира только при замере, несколько раз в секунду
+    int32 NumPlatforms = 0;
+    int32 NumMovingPlatforms = 0;
+    int32 NumTimers = 0;
+    for (TActorIterator<ADoodlePlatform> It(World); It; ++It)
+    {
+        ++NumPlatforms;
+        NumMovingPlatforms += It->PlatformType == EPlatformType::Moving ? 1 : 0;
+        NumTimers += It->GetActiveTimerCount();
+    }
+
+    int32 NumPowerUps = 0;
+    for (TActorIterator<APowerUpActor> It(World); It; ++It)
+    {
+        ++NumPowerUps;
+    }
+
+    const UWTowerGameInstance* GameInstance = World->GetGameInstance<UWTowerGameInstance>();
+    const UWAudioManager* AudioManager = GameInstance ? GameInstance->GetAudioManager() : nullptr;
+    const int32 NumVoices = AudioManager ? AudioManager->GetActiveVoiceCount() : 0;
+
+    Lines.Add(FText::FromString(FString::Printf(TEXT("Platforms %d (moving %d)  Power-ups %d"), NumPlatforms, NumMovingPlatforms, NumPowerUps)));
+    Lines.Add(FText::FromString(FString::Printf(TEXT("Platform timers %d  Voices %d"), NumTimers, NumVoices)));
+
+    // Среднее время тиков подсистем за кадр интервала
+    const int32 Frames = FMath::Max(FramesSinceSample, 1);
+    for (int32 Index = 0; Index < static_cast<int32>(EWTowerTickCost::Count); ++Index)
+    {
+        Lines.Add(FText::FromString(FString::Printf(TEXT("  %-10s %.3f ms"), TickCostNames[Index],
+            FPlatformTime::ToMilliseconds64(FWTowerTickCosts::Cycles[Index]) / Frames)));
+    }
+}
+
+//----------------------------------------------------------------------------------------
+// ОТРИСОВКА
+//----------------------------------------------------------------------------------------
+
+void FWTowerPerfOverlay::Draw(UCanvas* Canvas, UFont* Font, const FVector2D& Origin) const
+{
+    if (!Canvas || !Font)
+        return;
+
+    const float LineHeight = Font->GetMaxCharHeight() + 2.0f;
+    const FVector2D SparklineSize(240.0f, 40.0f);
+    const FVector2D PanelSize(340.0f, LineHeight * Lines.Num() + SparklineSize.Y + 16.0f);
+
+    FCanvasTileItem Background(Origin, PanelSize, FLinearColor(0.0f, 0.0f, 0.0f, 0.5f));
+    Background.BlendMode = SE_BLEND_Translucent;
+    Canvas->DrawItem(Background);
+
+    FVector2D Position = Origin + FVector2D(6.0f, 4.0f);
+    for (const FText& Line : Lines)
+    {
+        FCanvasTextItem Text(Position, Line, Font, FLinearColor::White);
+        Canvas->DrawItem(Text);
+        Position.Y += LineHeight;
+    }
+
+    DrawSparkline(Canvas, Position + FVector2D(0.0f, 4.0f), SparklineSize);
+}
+
+void FWTowerPerfOverlay::DrawSparkline(UCanvas* Canvas, const FVector2D& Position, const FVector2D& Size) const
+{
+    // Линия бюджета 16.7 мс (60 FPS)
+    const float BudgetY = Position.Y + Size.Y * (1.0f - 16.7f / SparklineMaxMs);
+    FCanvasLineItem Budget(FVector2D(Position.X, BudgetY), FVector2D(Position.X + Size.X, BudgetY));
+    Budget.SetColor(FLinearColor(0.2f, 0.6f, 0.2f, 0.8f));
+    Canvas->DrawItem(Budget);
+
+    // От старых кадров к новым; длинные кадры выделяются цветом
+    const float StepX = Size.X / (HistorySize - 1);
+    FVector2D Previous;
+    for (int32 Index = 0; Index < HistorySize; ++Index)
+    {
+        const float Ms = FrameHistory[(HistoryHead + Index) % HistorySize];
+        const FVector2D Point(Position.X + Index * StepX,
+            Position.Y + Size.Y * (1.0f - FMath::Clamp(Ms / SparklineMaxMs, 0.0f, 1.0f)));
+
+        if (Index > 0)
+        {
+            FCanvasLineItem Segment(Previous, Point);
+            Segment.SetColor(Ms > 16.7f ? FLinearColor(1.0f, 0.3f, 0.2f) : FLinearColor(0.9f, 0.9f, 0.9f));
+            Canvas->DrawItem(Segment);
+        }
+        Previous = Point;
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "WTowerStats.h"
+
+class UCanvas;
+class UFont;
+class UWorld;
+
+/**
+ * Оверлей производительности (Tower.PerfOverlay 1).
+ * Время кадра пишется в кольцевой буфер каждый кадр, остальное
+ * (потоки, количество объектов, время тиков подсистем) собирается
+ * несколько раз в секунду; рисуется через Canvas в AWTowerHUD::DrawHUD
+ */
+class WTOWER_API FWTowerPerfOverlay
+{
+public:
+    FWTowerPerfOverlay();
+
+    // Включен ли оверлей консольной переменной
+    static bool IsEnabled();
+
+    // Учесть кадр и при необходимости обновить показатели
+    void Tick(UWorld* World, float DeltaTime);
+
+    // Нарисовать оверлей от левого верхнего угла
+    void Draw(UCanvas* Canvas, UFont* Font, const FVector2D& Origin) const;
+
+private:
+    static constexpr int32 HistorySize = 120;
+    static constexpr float SampleInterval = 0.25f;
+
+    // Время кадров (мс), кольцевой буфер
+    float FrameHistory[HistorySize];
+    int32 HistoryHead;
+
+    float TimeSinceSample;
+    int32 FramesSinceSample;
+
+    // Строки последнего замера; текст строится при замере, чтобы отрисовка
+    // не добавляла выделений памяти к измеряемому кадру
+    TArray<FText> Lines;
+
+    void Sample(UWorld* World);
+    void DrawSparkline(UCanvas* Canvas, const FVector2D& Position, const FVector2D& Size) const;
+};
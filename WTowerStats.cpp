@@ -0,0 +1,46 @@
+#include "WTowerStats.h"
+
+bool FWTowerTickCosts::bEnabled = false;
+uint64 FWTowerTickCosts::Cycles[static_cast<int32>(EWTowerTickCost::Count)] = {};
+
+DEFINE_STAT(STAT_TowerPlatformTick);
+DEFINE_STAT(STAT_TowerPlatformLanded);
+DEFINE_STAT(STAT_TowerPlatformAppearance);
+DEFINE_STAT(STAT_TowerPlatformSetupPowerUp);
+DEFINE_STAT(STAT_TowerPowerUpActorTick);
+DEFINE_STAT(STAT_TowerApplyPowerUp);
+DEFINE_STAT(STAT_TowerPlayerTick);
+DEFINE_STAT(STAT_TowerPlayerUpdateHeight);
+DEFINE_STAT(STAT_TowerHUDTick);
+DEFINE_STAT(STAT_TowerSaveGame);
+DEFINE_STAT(STAT_TowerLoadGame);
+DEFINE_STAT(STAT_TowerApplySave);
+DEFINE_STAT(STAT_TowerSaveProgress);
+DEFINE_STAT(STAT_TowerConfigSave);
+DEFINE_STAT(STAT_TowerConfigLoad);
+DEFINE_STAT(STAT_TowerConfigApply);
+
+DEFINE_STAT(STAT_TowerLivePlatforms);
+DEFINE_STAT(STAT_TowerLivePowerUpActors);
+DEFINE_STAT(STAT_TowerActivePlatformTimers);
+
+DEFINE_STAT(STAT_TowerBounceLatencyReal);
+DEFINE_STAT(STAT_TowerBounceLatencySim);
+
+DEFINE_STAT(STAT_TowerSoftResetTime);
+
+DEFINE_STAT(STAT_TowerSaveLatency);
+DEFINE_STAT(STAT_TowerSaveWriteTime);
+DEFINE_STAT(STAT_TowerSavesWritten);
+DEFINE_STAT(STAT_TowerSavesCoalesced);
+DEFINE_STAT(STAT_TowerJournalWriteTime);
+DEFINE_STAT(STAT_TowerJournalRecords);
+DEFINE_STAT(STAT_TowerJournalCompactions);
+
+DEFINE_STAT(STAT_TowerVoicesStarted);
+DEFINE_STAT(STAT_TowerVoicesStolen);
+DEFINE_STAT(STAT_TowerVoicesMerged);
+DEFINE_STAT(STAT_TowerVoicesCulled);
+DEFINE_STAT(STAT_TowerAudioCacheHits);
+DEFINE_STAT(STAT_TowerAudioCacheMisses);
+DEFINE_STAT(STAT_TowerAudioCacheResidentKB);
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+/**
+ * Общая группа статистики игры (stat Tower)
+ */
+DECLARE_STATS_GROUP(TEXT("Tower"), STATGROUP_Tower, STATCAT_Advanced);
+
+// Замер области кода: счетчик тактов stat Tower. Со stats счетчик сам пишет событие
+// для Unreal Insights (канал cpu), поэтому отдельное событие трассировки добавляется только без stats
+#if STATS
+#define WTOWER_SCOPE_CYCLE(Stat) \
+    SCOPE_CYCLE_COUNTER(Stat)
+#else
+#define WTOWER_SCOPE_CYCLE(Stat) \
+    TRACE_CPUPROFILER_EVENT_SCOPE(Stat)
+#endif
+
+//----------------------------------------------------------------------------------------
+// ВРЕМЯ ИГРОВОГО КОДА
+//----------------------------------------------------------------------------------------
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Platform Tick"), STAT_TowerPlatformTick, STATGROUP_Tower, WTOWER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Platform Landed"), STAT_TowerPlatformLanded, STATGROUP_Tower, WTOWER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Platform Appearance"), STAT_TowerPlatformAppearance, STATGROUP_Tower, WTOWER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Platform Setup Power-Up"), STAT_TowerPlatformSetupPowerUp, STATGROUP_Tower, WTOWER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Power-Up Actor Tick"), STAT_TowerPowerUpActorTick, STATGROUP_Tower, WTOWER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Apply Power-Up"), STAT_TowerApplyPowerUp, STATGROUP_Tower, WTOWER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Player Tick"), STAT_TowerPlayerTick, STATGROUP_Tower, WTOWER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Player Update Height"), STAT_TowerPlayerUpdateHeight, STATGROUP_Tower, WTOWER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("HUD Widget Tick"), STAT_TowerHUDTick, STATGROUP_Tower, WTOWER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Save Game"), STAT_TowerSaveGame, STATGROUP_Tower, WTOWER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Load Game"), STAT_TowerLoadGame, STATGROUP_Tower, WTOWER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Apply Save"), STAT_TowerApplySave, STATGROUP_Tower, WTOWER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Save Progress Update"), STAT_TowerSaveProgress, STATGROUP_Tower, WTOWER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Config Save"), STAT_TowerConfigSave, STATGROUP_Tower, WTOWER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Config Load"), STAT_TowerConfigLoad, STATGROUP_Tower, WTOWER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Config Apply"), STAT_TowerConfigApply, STATGROUP_Tower, WTOWER_API);
+
+//----------------------------------------------------------------------------------------
+// ОБЪЕКТЫ
+//----------------------------------------------------------------------------------------
+
+// Акторы, находящиеся в мире (между BeginPlay и EndPlay)
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Live Platforms"), STAT_TowerLivePlatforms, STATGROUP_Tower, WTOWER_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Live Power-Up Actors"), STAT_TowerLivePowerUpActors, STATGROUP_Tower, WTOWER_API);
+
+// Запущенные таймеры тикающих платформ (пересчитывается каждый кадр)
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Active Platform Timers"), STAT_TowerActivePlatformTimers, STATGROUP_Tower, WTOWER_API);
+
+//----------------------------------------------------------------------------------------
+// ВРЕМЯ ТИКОВ ДЛЯ ОВЕРЛЕЯ
+//----------------------------------------------------------------------------------------
+
+// Подсистемы, время тиков которых показывает оверлей производительности
+enum class EWTowerTickCost : uint8
+{
+    Platforms,
+    PowerUps,
+    Player,
+    HUD,
+    Count
+};
+
+/**
+ * Накопленное время тиков подсистем (такты процессора, только игровой поток).
+ * Работает и в сборках без stats; пока оверлей выключен, замеры не выполняются
+ */
+struct WTOWER_API FWTowerTickCosts
+{
+    static bool bEnabled;
+    static uint64 Cycles[static_cast<int32>(EWTowerTickCost::Count)];
+
+    static void Reset()
+    {
+        FMemory::Memzero(Cycles);
+    }
+};
+
+// Замер времени области кода в счетчик подсистемы
+class FWTowerTickCostScope
+{
+public:
+    explicit FWTowerTickCostScope(EWTowerTickCost InCost)
+        : Cost(InCost)
+        , StartCycles(FWTowerTickCosts::bEnabled ? FPlatformTime::Cycles64() : 0)
+    {
+    }
+
+    ~FWTowerTickCostScope()
+    {
+        if (StartCycles != 0)
+        {
+            FWTowerTickCosts::Cycles[static_cast<int32>(Cost)] += FPlatformTime::Cycles64() - StartCycles;
+        }
+    }
+
+private:
+    EWTowerTickCost Cost;
+    uint64 StartCycles;
+};
+
+// Замер тика подсистемы: счетчик stat Tower (или событие трассировки) и время для оверлея
+// одним макросом, чтобы оба замера охватывали одну и ту же область
+#define WTOWER_SCOPE_TICK(Stat, Cost) \
+    WTOWER_SCOPE_CYCLE(Stat); \
+    FWTowerTickCostScope PREPROCESSOR_JOIN(TowerTickCost_, __LINE__)(EWTowerTickCost::Cost)
+
+//----------------------------------------------------------------------------------------
+// ДВИЖЕНИЕ
+//----------------------------------------------------------------------------------------
+
+// Задержка от приземления (или запроса прыжка) до отрыва в последнем отскоке, в реальном времени
+// (накопитель: значение держится до следующего отскока, счетчик обнулялся бы каждый кадр)
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Bounce Latency Real (ms)"), STAT_TowerBounceLatencyReal, STATGROUP_Tower, WTOWER_API);
+
+// Та же задержка во времени симуляции
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Bounce Latency Sim (ms)"), STAT_TowerBounceLatencySim, STATGROUP_Tower, WTOWER_API);
+
+//----------------------------------------------------------------------------------------
+// ЗАБЕГ
+//----------------------------------------------------------------------------------------
+
+// Длительность мягкого перезапуска забега без перезагрузки карты
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Soft Reset (ms)"), STAT_TowerSoftResetTime, STATGROUP_Tower, WTOWER_API);
+
+//----------------------------------------------------------------------------------------
+// СОХРАНЕНИЯ
+//----------------------------------------------------------------------------------------
+
+// Время от первой пометки сохранения до записи на диск
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Save Latency (ms)"), STAT_TowerSaveLatency, STATGROUP_Tower, WTOWER_API);
+
+// Время записи на диск на рабочем потоке
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Save Disk Write (ms)"), STAT_TowerSaveWriteTime, STATGROUP_Tower, WTOWER_API);
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Saves Written"), STAT_TowerSavesWritten, STATGROUP_Tower, WTOWER_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Saves Coalesced"), STAT_TowerSavesCoalesced, STATGROUP_Tower, WTOWER_API);
+
+// Время дописывания пачки записей в журнал на рабочем потоке
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Journal Append (ms)"), STAT_TowerJournalWriteTime, STATGROUP_Tower, WTOWER_API);
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Journal Records"), STAT_TowerJournalRecords, STATGROUP_Tower, WTOWER_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Journal Compactions"), STAT_TowerJournalCompactions, STATGROUP_Tower, WTOWER_API);
+
+//----------------------------------------------------------------------------------------
+// АУДИО
+//----------------------------------------------------------------------------------------
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Voices Started"), STAT_TowerVoicesStarted, STATGROUP_Tower, WTOWER_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Voices Stolen"), STAT_TowerVoicesStolen, STATGROUP_Tower, WTOWER_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Voices Merged"), STAT_TowerVoicesMerged, STATGROUP_Tower, WTOWER_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Voices Culled"), STAT_TowerVoicesCulled, STATGROUP_Tower, WTOWER_API);
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Audio Cache Hits"), STAT_TowerAudioCacheHits, STATGROUP_Tower, WTOWER_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Audio Cache Misses"), STAT_TowerAudioCacheMisses, STATGROUP_Tower, WTOWER_API);
+
+// Память звуков, удерживаемых кэшем
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Audio Cache Resident (KB)"), STAT_TowerAudioCacheResidentKB, STATGROUP_Tower, WTOWER_API);